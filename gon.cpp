@@ -4,6 +4,12 @@
 #include <fstream>
 #include <string>
 #include <cstdlib>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <algorithm>
+#include <mutex>
 
 
 static bool IsWhitespace(char c){
@@ -21,132 +27,419 @@ static void DefaultGonErrorCallback(const std::string& err){
     throw (std::string)err;
 }
 
-static bool ends_with(const std::string& str, const std::string& suffix){
+static bool ends_with(std::string_view str, std::string_view suffix){
     if(str.size() < suffix.size()) return false;
     for(int i = (int)str.size()-1, j = (int)suffix.size()-1; j>=0; j--, i--){
         if(str[i] != suffix[j]) return false;
     }
     return true;
 }
-static void remove_suffix(std::string& str, const std::string& suffix){
+template<class String>
+static void remove_suffix(String& str, std::string_view suffix){
     if(ends_with(str, suffix)){
-        str = std::string(str.begin(), str.end() - suffix.size());
+        str.resize(str.size() - suffix.size());
     }
 }
 
+//children_map is keyed by pmr strings and C++17 has no heterogeneous find, so lookups by a plain string need a temporary key.
+//the key is built in a stack buffer so lookups don't allocate (only names longer than the buffer fall back to the heap)
+struct MapKey {
+    char buffer[256];
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::string key;
+    MapKey(std::string_view name):arena(buffer, sizeof(buffer)),key(name.data(), name.size(), &arena){}
+};
+
+static std::string field_name(const GonObject& obj){
+    return !obj.name.empty()?std::string(obj.name):GonObject::last_accessed_named_field;
+}
+
 std::function<void(const std::string&)> GonObject::ErrorCallback = DefaultGonErrorCallback;
 const GonObject GonObject::null_gon;
 GonObject GonObject::non_const_null_gon;
-std::string GonObject::last_accessed_named_field = "";
-
-static std::vector<std::string> Tokenize(std::string data){
-    std::vector<std::string> tokens;
-
-    bool inString = false;
-    bool inComment = false;
-    bool escaped = false;
-    std::string current_token = "";
-    for(int i = 0; i<data.size(); i++){
-        if(!inString && !inComment){
-            if(IsSymbol(data[i])){
-                if(current_token != ""){
-                    tokens.push_back(current_token);
-                    current_token = "";
-                }
+thread_local std::string GonObject::last_accessed_named_field = "";
+
+//STATS
+
+#ifndef GON_NO_STATS
+static thread_local GonStats* current_stats = nullptr;
+static thread_local int merge_depth = 0; //only the outermost merge call is recorded
+#endif
+
+GonStatsScope::GonStatsScope([[maybe_unused]] GonStats& stats){
+    #ifndef GON_NO_STATS
+    previous = current_stats;
+    current_stats = &stats;
+    #else
+    previous = nullptr;
+    #endif
+}
+GonStatsScope::~GonStatsScope(){
+    #ifndef GON_NO_STATS
+    current_stats = previous;
+    #endif
+}
+GonStats* GonStatsScope::Current(){
+    #ifndef GON_NO_STATS
+    return current_stats;
+    #else
+    return nullptr;
+    #endif
+}
 
-                if(!IsIgnoredSymbol(data[i])){
-                    current_token += data[i];
-                    tokens.push_back(current_token);
-                    current_token = "";
-                }
-                continue;
+GonCountingResource::GonCountingResource(std::pmr::memory_resource* upstream):upstream(upstream),allocations(0),allocated_bytes(0),deallocations(0),bytes_in_use(0),peak_bytes_in_use(0){
+}
+uint64_t GonCountingResource::Allocations() const {
+    return allocations.load(std::memory_order_relaxed);
+}
+uint64_t GonCountingResource::AllocatedBytes() const {
+    return allocated_bytes.load(std::memory_order_relaxed);
+}
+uint64_t GonCountingResource::Deallocations() const {
+    return deallocations.load(std::memory_order_relaxed);
+}
+uint64_t GonCountingResource::BytesInUse() const {
+    return bytes_in_use.load(std::memory_order_relaxed);
+}
+uint64_t GonCountingResource::PeakBytesInUse() const {
+    return peak_bytes_in_use.load(std::memory_order_relaxed);
+}
+void* GonCountingResource::do_allocate(size_t bytes, size_t alignment){
+    void* res = upstream->allocate(bytes, alignment);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    uint64_t in_use = bytes_in_use.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    uint64_t peak = peak_bytes_in_use.load(std::memory_order_relaxed);
+    while(in_use > peak && !peak_bytes_in_use.compare_exchange_weak(peak, in_use, std::memory_order_relaxed)){
+    }
+    return res;
+}
+void GonCountingResource::do_deallocate(void* ptr, size_t bytes, size_t alignment){
+    upstream->deallocate(ptr, bytes, alignment);
+    deallocations.fetch_add(1, std::memory_order_relaxed);
+    bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+}
+bool GonCountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+//the stats a load records into, always null with GON_NO_STATS so everything below compiles away
+static GonStats* LoadStats([[maybe_unused]] const GonLoadOptions& options){
+    #ifndef GON_NO_STATS
+    return options.stats ? options.stats : current_stats;
+    #else
+    return nullptr;
+    #endif
+}
+
+static double StatsClock(){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//times one phase into a GonStats field (if total isn't null) and calls the tracing hooks around it, does nothing for null stats
+struct GonStatsPhase {
+    GonStats* stats;
+    const char* name;
+    double GonStats::* total;
+    double start;
+
+    GonStatsPhase(GonStats* stats, const char* name, double GonStats::* total):stats(stats),name(name),total(total),start(0){
+        if(!stats) return;
+        if(stats->OnBegin) stats->OnBegin(name);
+        start = StatsClock();
+    }
+    ~GonStatsPhase(){
+        End();
+    }
+
+    //ends the phase early
+    void End(){
+        if(!stats) return;
+        if(total) stats->*total += StatsClock() - start;
+        if(stats->OnEnd) stats->OnEnd(name);
+        stats = nullptr;
+    }
+};
+
+//adds what was allocated while it exists to stats, if resource is a GonCountingResource
+struct GonStatsAllocations {
+    GonStats* stats;
+    const GonCountingResource* counting;
+    uint64_t allocations;
+    uint64_t bytes;
+
+    GonStatsAllocations(GonStats* stats, std::pmr::memory_resource* resource):stats(stats),counting(nullptr),allocations(0),bytes(0){
+        if(stats) counting = dynamic_cast<const GonCountingResource*>(resource);
+        if(!counting) return;
+        allocations = counting->Allocations();
+        bytes = counting->AllocatedBytes();
+    }
+    ~GonStatsAllocations(){
+        if(!counting) return;
+        stats->allocations += counting->Allocations() - allocations;
+        stats->allocated_bytes += counting->AllocatedBytes() - bytes;
+    }
+};
+
+//records the outermost merge call on this thread into the current scope's stats
+struct GonStatsMerge {
+    #ifndef GON_NO_STATS
+    GonStats* stats;
+    GonStatsAllocations allocations;
+    GonStatsPhase phase;
+
+    GonStatsMerge(GonObject& obj):stats(merge_depth++ == 0 ? current_stats : nullptr),allocations(stats, obj.get_allocator().resource()),phase(stats, "merge", &GonStats::merge_seconds){
+        if(stats) stats->merges++;
+    }
+    ~GonStatsMerge(){
+        merge_depth--;
+    }
+    #else
+    GonStatsMerge(GonObject&){
+    }
+    #endif
+};
+
+static void RecordTree(GonStats& stats, const GonObject& obj, int depth){
+    stats.nodes++;
+    if(depth > stats.max_depth) stats.max_depth = depth;
+    for(const GonObject& child : obj.children_array){
+        RecordTree(stats, child, depth+1);
+    }
+}
+
+//ACCESS PROFILER
+
+#ifdef GON_ACCESS_PROFILER
+struct GonAccessCounts {
+    uint64_t lookups = 0;
+    uint64_t reads = 0;
+};
+
+//one per thread, the owning thread is the only writer so its mutex is uncontended unless a report or reset is running
+struct GonAccessCounters {
+    std::mutex mutex;
+    std::unordered_map<const GonObject*, GonAccessCounts> nodes;
+    std::unordered_map<const GonObject*, std::vector<std::pair<std::string, uint64_t>>> misses; //by parent, few distinct missing keys per parent so a list is enough
+
+    void AddMiss(const GonObject* parent, std::string_view key, uint64_t count){
+        std::vector<std::pair<std::string, uint64_t>>& keys = misses[parent];
+        for(auto& entry : keys){
+            if(entry.first == key){
+                entry.second += count;
+                return;
             }
+        }
+        keys.emplace_back(std::string(key), count);
+    }
+    void AddTo(GonAccessCounters& total) const {
+        for(auto& node : nodes){
+            GonAccessCounts& counts = total.nodes[node.first];
+            counts.lookups += node.second.lookups;
+            counts.reads += node.second.reads;
+        }
+        for(auto& parent : misses){
+            for(auto& entry : parent.second) total.AddMiss(parent.first, entry.first, entry.second);
+        }
+    }
+    void Clear(){
+        nodes.clear();
+        misses.clear();
+    }
+};
 
-            if(IsWhitespace(data[i])){
-                if(current_token != ""){
-                    tokens.push_back(current_token);
-                    current_token = "";
+//counts of threads that exited are kept in retired
+struct GonAccessRegistry {
+    std::mutex mutex;
+    std::vector<GonAccessCounters*> threads;
+    GonAccessCounters retired;
+};
+static GonAccessRegistry& AccessRegistry(){
+    static GonAccessRegistry* registry = new GonAccessRegistry(); //never destroyed, threads can still exit during static destruction
+    return *registry;
+}
+
+struct GonThreadAccessCounters {
+    GonAccessCounters counters;
+
+    GonThreadAccessCounters(){
+        GonAccessRegistry& registry = AccessRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.push_back(&counters);
+    }
+    ~GonThreadAccessCounters(){
+        GonAccessRegistry& registry = AccessRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), &counters));
+        std::lock_guard<std::mutex> counters_lock(counters.mutex);
+        counters.AddTo(registry.retired);
+    }
+};
+static GonAccessCounters& ThreadAccessCounters(){
+    static thread_local GonThreadAccessCounters thread_counters;
+    return thread_counters.counters;
+}
+
+static std::atomic<bool> access_profiler_running(false);
+
+//found is null for a miss, lookups on null objects aren't counted since the miss that produced them already was
+static void ProfileLookup(const GonObject& parent, const GonObject* found, std::string_view key){
+    if(!access_profiler_running.load(std::memory_order_relaxed)) return;
+    if(parent.type == GonObject::FieldType::NULLGON) return;
+    GonAccessCounters& counters = ThreadAccessCounters();
+    std::lock_guard<std::mutex> lock(counters.mutex);
+    if(found) counters.nodes[found].lookups++;
+    else counters.AddMiss(&parent, key, 1);
+}
+static void ProfileRead(const GonObject& obj){
+    if(!access_profiler_running.load(std::memory_order_relaxed)) return;
+    if(obj.type == GonObject::FieldType::NULLGON) return;
+    GonAccessCounters& counters = ThreadAccessCounters();
+    std::lock_guard<std::mutex> lock(counters.mutex);
+    counters.nodes[&obj].reads++;
+}
+#else
+static void ProfileLookup(const GonObject&, const GonObject*, std::string_view){
+}
+static void ProfileRead(const GonObject&){
+}
+#endif
+
+typedef std::pmr::vector<std::pmr::string> GonTokens;
+
+//the tokenizer keeps its state between calls to Feed, so a document can also be tokenized as it arrives (see GonStreamParser)
+struct GonTokenizer {
+    GonTokens tokens;
+    std::pmr::string current_token;
+    bool inString;
+    bool inComment;
+    bool escaped;
+
+    GonTokenizer(std::pmr::memory_resource* scratch):tokens(scratch),current_token(scratch),inString(false),inComment(false),escaped(false){
+    }
+
+    void Feed(std::string_view data){
+        //flags are copied to locals for the loop
+        bool inString = this->inString;
+        bool inComment = this->inComment;
+        bool escaped = this->escaped;
+        for(size_t i = 0; i<data.size(); i++){
+            if(!inString && !inComment){
+                if(IsSymbol(data[i])){
+                    if(current_token != ""){
+                        tokens.push_back(current_token);
+                        current_token = "";
+                    }
+
+                    if(!IsIgnoredSymbol(data[i])){
+                        current_token += data[i];
+                        tokens.push_back(current_token);
+                        current_token = "";
+                    }
+                    continue;
                 }
 
-                continue;
-            }
+                if(IsWhitespace(data[i])){
+                    if(current_token != ""){
+                        tokens.push_back(current_token);
+                        current_token = "";
+                    }
 
-            if(data[i] == '#'){
-                if(current_token != ""){
-                    tokens.push_back(current_token);
-                    current_token = "";
+                    continue;
                 }
 
-                inComment = true;
-                continue;
-            }
-            if(data[i] == '"'){
-                if(current_token != ""){
-                    tokens.push_back(current_token);
-                    current_token = "";
+                if(data[i] == '#'){
+                    if(current_token != ""){
+                        tokens.push_back(current_token);
+                        current_token = "";
+                    }
+
+                    inComment = true;
+                    continue;
                 }
+                if(data[i] == '"'){
+                    if(current_token != ""){
+                        tokens.push_back(current_token);
+                        current_token = "";
+                    }
 
-                inString = true;
-                continue;
-            }
+                    inString = true;
+                    continue;
+                }
 
-            current_token += data[i];
-        }
+                current_token += data[i];
+            }
 
-        if(inString){
-            if(escaped){
-                if(data[i] == 'n'){
-                    current_token += '\n';
+            if(inString){
+                if(escaped){
+                    if(data[i] == 'n'){
+                        current_token += '\n';
+                    } else {
+                        current_token += data[i];
+                    }
+                    escaped = false;
+                } else if(data[i] == '\\'){
+                    escaped = true;
+                } else if(!escaped && data[i] == '"'){
+                    tokens.push_back(current_token);
+                    current_token = "";
+                    inString = false;
+                    continue;
                 } else {
                     current_token += data[i];
+                    continue;
                 }
-                escaped = false;
-            } else if(data[i] == '\\'){
-                escaped = true;
-            } else if(!escaped && data[i] == '"'){
-                tokens.push_back(current_token);
-                current_token = "";
-                inString = false;
-                continue;
-            } else {
-                current_token += data[i];
-                continue;
             }
-        }
 
-        if(inComment){
-            if(data[i] == '\n'){
-                inComment = false;
-                continue;
+            if(inComment){
+                if(data[i] == '\n'){
+                    inComment = false;
+                    continue;
+                }
             }
         }
+
+        this->inString = inString;
+        this->inComment = inComment;
+        this->escaped = escaped;
     }
 
-    if(current_token != "") tokens.push_back(current_token);
+    void Finish(){
+        if(current_token != "") tokens.push_back(current_token);
+    }
+};
 
-    return tokens;
+//tokens only live for the duration of a load, so Load/LoadFromBuffer hand in a scratch arena for them
+static GonTokens Tokenize(std::string_view data, std::pmr::memory_resource* scratch = std::pmr::get_default_resource()){
+    GonTokenizer tokenizer(scratch);
+    tokenizer.Feed(data);
+    tokenizer.Finish();
+    return std::move(tokenizer.tokens);
 }
 
 struct GonTokenStream {
-    std::vector<std::string> Tokens;
+    GonTokens Tokens;
     int current;
     bool error;
+    GonStats* stats;
 
-    GonTokenStream():current(0),error(false){
+    GonTokenStream(std::pmr::memory_resource* scratch):Tokens(scratch),current(0),error(false),stats(nullptr){
     }
 
-    std::string Read(){
+    const std::pmr::string& Read(){
+        static const std::pmr::string end_token = "!";
         if(current>=Tokens.size()){
             error = true;
-            return "!";
+            return end_token;
         }
 
         return Tokens[current++];
     }
-    std::string Peek(){
+    const std::pmr::string& Peek(){
+        static const std::pmr::string end_token = "!";
         if(current>=Tokens.size()){
             error = true;
-            return "!";
+            return end_token;
         }
         return Tokens[current];
     }
@@ -168,18 +461,164 @@ GonObject::GonObject(){
     bool_data = 0;
     string_data = "";
 }
+GonObject::GonObject(const allocator_type& alloc):children_map(alloc),children_array(alloc),string_data(alloc),name(alloc){
+    type = FieldType::NULLGON;
+    int_data = 0;
+    float_data = 0;
+    bool_data = 0;
+}
+GonObject::GonObject(const GonObject& other, const allocator_type& alloc):
+    children_map(other.children_map, alloc),
+    children_array(other.children_array, alloc),
+    int_data(other.int_data),
+    float_data(other.float_data),
+    bool_data(other.bool_data),
+    string_data(other.string_data, alloc),
+    name(other.name, alloc),
+    type(other.type){
+}
+GonObject::GonObject(GonObject&& other, const allocator_type& alloc):
+    children_map(std::move(other.children_map), alloc),
+    children_array(std::move(other.children_array), alloc),
+    int_data(other.int_data),
+    float_data(other.float_data),
+    bool_data(other.bool_data),
+    string_data(std::move(other.string_data), alloc),
+    name(std::move(other.name), alloc),
+    type(other.type),
+    indexes(std::move(other.indexes)){
+}
 
-static GonObject LoadFromTokens(GonTokenStream& Tokens){
-    GonObject ret;
+GonObject::allocator_type GonObject::get_allocator() const {
+    return children_array.get_allocator();
+}
+
+static bool IsSpace(char c){
+    return IsWhitespace(c)||c=='\v'||c=='\f';
+}
+
+static int64_t DoubleToInt64(double value){
+    if(value != value) return 0;
+    if(value >= 9223372036854775807.0) return INT64_MAX;
+    if(value <= -9223372036854775808.0) return INT64_MIN;
+    return (int64_t)value;
+}
+
+//whole string as an integer with the prefixes strtol(str, &end, 0) accepts (sign, 0x for hex, leading 0 for octal), but 64 bit and without silent truncation
+static bool ParseInteger(std::string_view str, int64_t& out){
+    size_t pos = 0;
+    while(pos < str.size() && IsSpace(str[pos])) pos++;
+
+    bool negative = false;
+    if(pos < str.size() && (str[pos] == '+' || str[pos] == '-')){
+        negative = str[pos] == '-';
+        pos++;
+    }
+
+    int base = 10;
+    if(str.size()-pos > 2 && str[pos] == '0' && (str[pos+1] == 'x' || str[pos+1] == 'X')){
+        base = 16;
+        pos += 2;
+    } else if(str.size()-pos > 1 && str[pos] == '0'){
+        base = 8;
+        pos++;
+    }
+    if(pos >= str.size()) return false;
+
+    uint64_t magnitude;
+    std::from_chars_result res = std::from_chars(str.data()+pos, str.data()+str.size(), magnitude, base);
+    if(res.ec != std::errc() || res.ptr != str.data()+str.size()) return false;
+
+    if(negative){
+        if(magnitude > (uint64_t)INT64_MAX+1) return false;
+        out = (int64_t)(0-magnitude);
+    } else {
+        if(magnitude > (uint64_t)INT64_MAX) return false;
+        out = (int64_t)magnitude;
+    }
+    return true;
+}
+
+//whole string as a double, from_chars is exact and locale independent, strtod is only used for the forms it doesn't take (leading whitespace or '+', hex, out of range)
+static bool ParseDouble(const std::pmr::string& str, double& out){
+    const char* end = str.data()+str.size();
+    std::from_chars_result res = std::from_chars(str.data(), end, out);
+    if(res.ec == std::errc() && res.ptr == end) return true;
+
+    bool strtod_form = res.ec == std::errc::result_out_of_range || (!str.empty() && (IsSpace(str[0]) || str[0] == '+')) || (res.ptr < end && (*res.ptr == 'x' || *res.ptr == 'X'));
+    if(!strtod_form) return false;
+
+    char* endptr;
+    out = strtod(str.c_str(), &endptr);
+    return *endptr == 0;
+}
+
+//shortest text that reads back as the same number, integers are written exactly (except -0, which only the double form keeps)
+template<class String>
+static void AppendNumber(String& out, int64_t int_value, double float_value){
+    char buffer[32];
+    std::to_chars_result res;
+    if((double)int_value == float_value && (int_value != 0 || !std::signbit(float_value))){
+        res = std::to_chars(buffer, buffer+sizeof(buffer), int_value);
+    } else {
+        res = std::to_chars(buffer, buffer+sizeof(buffer), float_value);
+    }
+    out.append(buffer, res.ptr-buffer);
+}
+
+//sets the type (and number/bool data) of a value from its string_data, the same way for every syntax
+static void ClassifyScalar(GonObject& ret){
+    ret.type = GonObject::FieldType::STRING;
+    ret.int_data = 0;
+    ret.float_data = 0;
+
+    //if string data can be converted to a number, do so
+    int64_t int_value = 0;
+    double float_value = 0;
+    bool is_int = ParseInteger(ret.string_data, int_value);
+    bool is_float = ParseDouble(ret.string_data, float_value);
+    if(is_int || is_float){
+        ret.type = GonObject::FieldType::NUMBER;
+        ret.int_data = is_int?int_value:DoubleToInt64(float_value);
+        ret.float_data = is_float?float_value:(double)int_value;
+    }
+
+    //if string data can be converted to a bool or null, convert
+    if(ret.string_data == "null") ret.type = GonObject::FieldType::NULLGON;
+    if(ret.string_data == "true") {
+        ret.type = GonObject::FieldType::BOOL;
+        ret.bool_data = true;
+    }
+    if(ret.string_data == "false") {
+        ret.type = GonObject::FieldType::BOOL;
+        ret.bool_data = false;
+    }
+}
+
+static void ClassifyScalar(GonObject& ret, [[maybe_unused]] GonStats* stats){
+    #ifndef GON_NO_STATS
+    if(stats){
+        double start = StatsClock();
+        ClassifyScalar(ret);
+        stats->number_seconds += StatsClock() - start;
+        if(ret.type == GonObject::FieldType::NUMBER) stats->numbers++;
+        return;
+    }
+    #endif
+    ClassifyScalar(ret);
+}
+
+static GonObject LoadFromTokens(GonTokenStream& Tokens, const GonObject::allocator_type& alloc){
+    GonObject ret(alloc);
 
     if(Tokens.Peek() == "{"){         //read object
         ret.type = GonObject::FieldType::OBJECT;
 
         Tokens.Consume(); //consume '{'
         while(Tokens.Peek() != "}"){
-            std::string name = Tokens.Read();
+            const std::pmr::string& name = Tokens.Read();
 
-            ret.children_array.push_back(LoadFromTokens(Tokens));
+            ret.children_array.push_back(LoadFromTokens(Tokens, alloc));
             ret.children_map[name] = (int)ret.children_array.size()-1;
             ret.children_array[ret.children_array.size()-1].name = name;
 
@@ -196,7 +635,7 @@ static GonObject LoadFromTokens(GonTokenStream& Tokens){
 
         Tokens.Consume(); //consume '['
         while(Tokens.Peek() != "]"){
-            ret.children_array.push_back(LoadFromTokens(Tokens));
+            ret.children_array.push_back(LoadFromTokens(Tokens, alloc));
 
             if(Tokens.error) {
                 GonObject::ErrorCallback("GON ERROR: missing a ']' somewhere");
@@ -207,93 +646,722 @@ static GonObject LoadFromTokens(GonTokenStream& Tokens){
 
         return ret;
     } else {                          //read data value
-        ret.type = GonObject::FieldType::STRING;
         ret.string_data = Tokens.Read();
+        ClassifyScalar(ret, Tokens.stats);
+
+        return ret;
+    }
+}
+
+//strict JSON (RFC 8259) parser that builds the same tree LoadFromTokens would, without tokenizing
+//the root object/array becomes the returned object, scalars are classified like GON values (so "5" is still a NUMBER)
+struct GonJsonParser {
+    std::string_view data;
+    size_t pos;
+    GonObject::allocator_type alloc;
+    std::string error;
+    GonStats* stats;
+
+    GonJsonParser(std::string_view data, const GonObject::allocator_type& alloc, GonStats* stats):data(data),pos(0),alloc(alloc),stats(stats){
+    }
+
+    bool Fail(const char* what){
+        if(error.empty()){
+            int line = 1;
+            for(size_t i = 0; i<pos && i<data.size(); i++){
+                if(data[i] == '\n') line++;
+            }
+            error = std::string("GON ERROR: invalid JSON, ")+what+" on line "+std::to_string(line);
+        }
+        return false;
+    }
+
+    void SkipWhitespace(){
+        while(pos < data.size() && IsWhitespace(data[pos])) pos++;
+    }
+
+    bool Expect(char c){
+        SkipWhitespace();
+        if(pos >= data.size() || data[pos] != c) return false;
+        pos++;
+        return true;
+    }
+
+    static int HexDigit(char c){
+        if(c >= '0' && c <= '9') return c-'0';
+        if(c >= 'a' && c <= 'f') return c-'a'+10;
+        if(c >= 'A' && c <= 'F') return c-'A'+10;
+        return -1;
+    }
+
+    bool ReadHex4(unsigned& out){
+        if(pos+4 > data.size()) return false;
+        out = 0;
+        for(int i = 0; i<4; i++){
+            int digit = HexDigit(data[pos++]);
+            if(digit < 0) return false;
+            out = out*16 + digit;
+        }
+        return true;
+    }
+
+    static void AppendUtf8(std::pmr::string& out, unsigned cp){
+        if(cp < 0x80){
+            out += (char)cp;
+        } else if(cp < 0x800){
+            out += (char)(0xC0 | (cp >> 6));
+            out += (char)(0x80 | (cp & 0x3F));
+        } else if(cp < 0x10000){
+            out += (char)(0xE0 | (cp >> 12));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+        } else {
+            out += (char)(0xF0 | (cp >> 18));
+            out += (char)(0x80 | ((cp >> 12) & 0x3F));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+        }
+    }
 
-        //if string data can be converted to a number, do so
-        char*endptr;
-        ret.int_data = strtol(ret.string_data.c_str(), &endptr, 0);
-        if(*endptr == 0){
-            ret.type = GonObject::FieldType::NUMBER;
+    //reads a string starting at the opening quote
+    bool ReadString(std::pmr::string& out){
+        pos++; //consume '"'
+        for(;;){
+            //copy runs of plain characters in one go
+            size_t start = pos;
+            while(pos < data.size() && data[pos] != '"' && data[pos] != '\\' && (unsigned char)data[pos] >= 0x20) pos++;
+            out.append(data.data()+start, pos-start);
+
+            if(pos >= data.size()) return Fail("unterminated string");
+            char c = data[pos++];
+            if(c == '"') return true;
+            if(c != '\\') return Fail("control character in string");
+
+            if(pos >= data.size()) return Fail("unterminated string");
+            c = data[pos++];
+            switch(c){
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    unsigned cp;
+                    if(!ReadHex4(cp)) return Fail("bad \\u escape");
+                    if(cp >= 0xD800 && cp <= 0xDBFF){
+                        unsigned low;
+                        if(pos+2 > data.size() || data[pos] != '\\' || data[pos+1] != 'u') return Fail("unpaired surrogate");
+                        pos += 2;
+                        if(!ReadHex4(low) || low < 0xDC00 || low > 0xDFFF) return Fail("unpaired surrogate");
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    } else if(cp >= 0xDC00 && cp <= 0xDFFF){
+                        return Fail("unpaired surrogate");
+                    }
+                    AppendUtf8(out, cp);
+                    break;
+                }
+                default:
+                    return Fail("bad escape");
+            }
         }
+    }
+
+    static bool IsDigit(char c){
+        return c >= '0' && c <= '9';
+    }
+
+    //-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    bool ReadNumber(GonObject& ret){
+        size_t start = pos;
+        if(pos < data.size() && data[pos] == '-') pos++;
+        if(pos >= data.size() || !IsDigit(data[pos])) return Fail("bad number");
+        if(data[pos] == '0'){
+            pos++;
+        } else {
+            while(pos < data.size() && IsDigit(data[pos])) pos++;
+        }
+        if(pos < data.size() && data[pos] == '.'){
+            pos++;
+            if(pos >= data.size() || !IsDigit(data[pos])) return Fail("bad number");
+            while(pos < data.size() && IsDigit(data[pos])) pos++;
+        }
+        if(pos < data.size() && (data[pos] == 'e' || data[pos] == 'E')){
+            pos++;
+            if(pos < data.size() && (data[pos] == '+' || data[pos] == '-')) pos++;
+            if(pos >= data.size() || !IsDigit(data[pos])) return Fail("bad number");
+            while(pos < data.size() && IsDigit(data[pos])) pos++;
+        }
+        ret.string_data.assign(data.data()+start, pos-start);
+        ClassifyScalar(ret, stats);
+        return true;
+    }
+
+    bool ReadLiteral(GonObject& ret, std::string_view literal){
+        if(data.substr(pos, literal.size()) != literal) return Fail("unexpected character");
+        pos += literal.size();
+        ret.string_data.assign(literal.data(), literal.size());
+        ClassifyScalar(ret, stats);
+        return true;
+    }
+
+    bool ReadValue(GonObject& ret){
+        SkipWhitespace();
+        if(pos >= data.size()) return Fail("unexpected end of input");
+
+        char c = data[pos];
+        if(c == '{'){
+            ret.type = GonObject::FieldType::OBJECT;
+            pos++;
+            SkipWhitespace();
+            if(pos < data.size() && data[pos] == '}'){
+                pos++;
+                return true;
+            }
+            for(;;){
+                SkipWhitespace();
+                if(pos >= data.size() || data[pos] != '"') return Fail("expected a quoted key");
+
+                ret.children_array.emplace_back();
+                GonObject& child = ret.children_array.back();
+                if(!ReadString(child.name)) return false;
+                if(!Expect(':')) return Fail("expected ':'");
+                if(!ReadValue(child)) return false;
+                ret.children_map[child.name] = (int)ret.children_array.size()-1;
+
+                if(Expect(',')) continue;
+                if(Expect('}')) return true;
+                return Fail("expected ',' or '}'");
+            }
+        } else if(c == '['){
+            ret.type = GonObject::FieldType::ARRAY;
+            pos++;
+            SkipWhitespace();
+            if(pos < data.size() && data[pos] == ']'){
+                pos++;
+                return true;
+            }
+            for(;;){
+                ret.children_array.emplace_back();
+                if(!ReadValue(ret.children_array.back())) return false;
+
+                if(Expect(',')) continue;
+                if(Expect(']')) return true;
+                return Fail("expected ',' or ']'");
+            }
+        } else if(c == '"'){
+            if(!ReadString(ret.string_data)) return false;
+            ClassifyScalar(ret, stats);
+            return true;
+        } else if(c == '-' || IsDigit(c)){
+            return ReadNumber(ret);
+        } else if(c == 't'){
+            return ReadLiteral(ret, "true");
+        } else if(c == 'f'){
+            return ReadLiteral(ret, "false");
+        } else if(c == 'n'){
+            return ReadLiteral(ret, "null");
+        }
+        return Fail("unexpected character");
+    }
+
+    bool Parse(GonObject& ret){
+        if(data.substr(0, 3) == "\xEF\xBB\xBF") pos = 3; //utf-8 byte order mark
+        if(!ReadValue(ret)) return false;
+        SkipWhitespace();
+        if(pos != data.size()) return Fail("trailing characters after the root value");
+        return true;
+    }
+};
+
+//a document is treated as json if it is a bare array, or an object whose first key is quoted (a gon file can't start with '{')
+static bool LooksLikeJson(std::string_view data){
+    size_t pos = 0;
+    if(data.substr(0, 3) == "\xEF\xBB\xBF") pos = 3;
+    while(pos < data.size() && IsWhitespace(data[pos])) pos++;
+    if(pos >= data.size()) return false;
+    if(data[pos] == '[') return true;
+    if(data[pos] != '{') return false;
+    pos++;
+    while(pos < data.size() && IsWhitespace(data[pos])) pos++;
+    return pos < data.size() && (data[pos] == '"' || data[pos] == '}');
+}
+
+static void ResolveDocumentIncludes(GonObject& doc, const GonLoadOptions& options);
+
+//data is the document, wrapped is the document surrounded by '{' '}' (built here if null), which is what the gon tokenizer expects
+static GonObject LoadFromText(std::string_view data, const std::string* wrapped, const GonLoadOptions& options){
+    GonObject::allocator_type alloc(options.resource);
+
+    GonStats* stats = LoadStats(options);
+    GonStatsAllocations allocations(stats, options.resource);
+    GonStatsPhase parse_phase(stats, "parse", nullptr);
+    if(stats){
+        stats->loads++;
+        stats->bytes_read += data.size();
+    }
 
-        ret.float_data = strtod(ret.string_data.c_str(), &endptr);
-        if(*endptr == 0){
-            ret.type = GonObject::FieldType::NUMBER;
+    if(options.syntax == GonLoadOptions::Syntax::JSON || (options.syntax == GonLoadOptions::Syntax::AUTO && LooksLikeJson(data))){
+        //counters the attempt adds to, put back if it fails so the regular parser below doesn't count the same values twice
+        uint64_t numbers = stats ? stats->numbers : 0;
+        double build_seconds = stats ? stats->build_seconds : 0;
+        double number_seconds = stats ? stats->number_seconds : 0;
+
+        GonObject ret(alloc);
+        GonJsonParser parser(data, alloc, stats);
+        GonStatsPhase build_phase(stats, "build", &GonStats::build_seconds);
+        bool parsed = parser.Parse(ret);
+        build_phase.End();
+        if(parsed){
+            if(stats) RecordTree(*stats, ret, 0);
+            if(options.includes) ResolveDocumentIncludes(ret, options);
+            return ret;
         }
 
-        //if string data can be converted to a bool or null, convert
-        if(ret.string_data == "null") ret.type = GonObject::FieldType::NULLGON;
-        if(ret.string_data == "true") {
-            ret.type = GonObject::FieldType::BOOL;
-            ret.bool_data = true;
+        if(options.syntax == GonLoadOptions::Syntax::JSON){
+            GonObject::ErrorCallback(parser.error);
+            return GonObject::null_gon;
         }
-        if(ret.string_data == "false") {
-            ret.type = GonObject::FieldType::BOOL;
-            ret.bool_data = false;
+        //auto-detected documents that aren't strict json still go through the regular parser
+        if(stats){
+            stats->numbers = numbers;
+            stats->build_seconds = build_seconds;
+            stats->number_seconds = number_seconds;
         }
+    }
 
-        return ret;
+    std::string wrapped_buffer;
+    if(!wrapped){
+        wrapped_buffer.reserve(data.size()+2);
+        wrapped_buffer += '{';
+        wrapped_buffer += data;
+        wrapped_buffer += '}';
+        wrapped = &wrapped_buffer;
     }
+
+    std::pmr::monotonic_buffer_resource scratch;
+
+    GonTokenStream ts(&scratch);
+    ts.current = 0;
+    ts.stats = stats;
+    {
+        GonStatsPhase tokenize_phase(stats, "tokenize", &GonStats::tokenize_seconds);
+        ts.Tokens = Tokenize(*wrapped, &scratch);
+    }
+    if(stats) stats->tokens += ts.Tokens.size() - 2; //not counting the braces around the document
+
+    GonStatsPhase build_phase(stats, "build", &GonStats::build_seconds);
+    GonObject ret = LoadFromTokens(ts, alloc);
+    build_phase.End();
+    if(stats) RecordTree(*stats, ret, 0);
+    if(options.includes) ResolveDocumentIncludes(ret, options);
+    return ret;
+}
+
+struct GonStreamParser::State {
+    GonLoadOptions options;
+    std::pmr::monotonic_buffer_resource scratch;
+    GonTokenizer tokenizer;
+    std::string pending; //text seen before the syntax is known, or the whole document for json
+    bool decided;
+    bool json;
+    uint64_t bytes_fed;
+
+    State(const GonLoadOptions& options):options(options),tokenizer(&scratch),decided(false),json(false),bytes_fed(0){
+    }
+};
+
+//whether enough of the document has arrived for LooksLikeJson to give its final answer
+static bool CanDetectSyntax(std::string_view data){
+    size_t pos = 0;
+    if(data.substr(0, 3) == "\xEF\xBB\xBF") pos = 3;
+    else if(data.size() < 3 && !data.empty() && data[0] == '\xEF') return false;
+    while(pos < data.size() && IsWhitespace(data[pos])) pos++;
+    if(pos >= data.size()) return false;
+    if(data[pos] != '{') return true;
+    pos++;
+    while(pos < data.size() && IsWhitespace(data[pos])) pos++;
+    return pos < data.size();
+}
+
+GonStreamParser::GonStreamParser(const GonLoadOptions& options):state(new State(options)){
+    if(options.syntax == GonLoadOptions::Syntax::GON){
+        state->decided = true;
+        state->tokenizer.Feed("{");
+    }
+    if(options.syntax == GonLoadOptions::Syntax::JSON){
+        state->decided = true;
+        state->json = true;
+    }
+}
+GonStreamParser::~GonStreamParser(){
+}
+
+void GonStreamParser::Feed(std::string_view chunk){
+    state->bytes_fed += chunk.size();
+    if(state->decided && !state->json){
+        GonStatsPhase tokenize_phase(LoadStats(state->options), "tokenize", &GonStats::tokenize_seconds);
+        state->tokenizer.Feed(chunk);
+        return;
+    }
+
+    state->pending += chunk;
+    if(!state->decided && CanDetectSyntax(state->pending)){
+        state->decided = true;
+        state->json = LooksLikeJson(state->pending);
+        if(!state->json){
+            state->tokenizer.Feed("{");
+            state->tokenizer.Feed(state->pending);
+            state->pending = std::string();
+        }
+    }
+}
+
+GonObject GonStreamParser::Finish(){
+    if(!state->decided || state->json){
+        return LoadFromText(state->pending, nullptr, state->options);
+    }
+
+    GonStats* stats = LoadStats(state->options);
+    GonStatsAllocations allocations(stats, state->options.resource);
+    GonStatsPhase parse_phase(stats, "parse", nullptr);
+    {
+        GonStatsPhase tokenize_phase(stats, "tokenize", &GonStats::tokenize_seconds);
+        state->tokenizer.Feed("}");
+        state->tokenizer.Finish();
+    }
+
+    GonTokenStream ts(&state->scratch);
+    ts.current = 0;
+    ts.stats = stats;
+    ts.Tokens = std::move(state->tokenizer.tokens);
+    if(stats){
+        stats->loads++;
+        stats->bytes_read += state->bytes_fed;
+        stats->tokens += ts.Tokens.size() - 2;
+    }
+
+    GonStatsPhase build_phase(stats, "build", &GonStats::build_seconds);
+    GonObject ret = LoadFromTokens(ts, GonObject::allocator_type(state->options.resource));
+    build_phase.End();
+    if(stats) RecordTree(*stats, ret, 0);
+    if(state->options.includes) ResolveDocumentIncludes(ret, state->options);
+    return ret;
+}
+
+uint64_t GonStreamParser::BytesFed() const {
+    return state->bytes_fed;
 }
 
 GonObject GonObject::Load(const std::string& filename){
-    std::ifstream in(filename.c_str(), std::ios::binary);
-    in.seekg (0, std::ios::end);
-    std::streamoff length = in.tellg();
-    in.seekg (0, std::ios::beg);
-    std::string str(length + 2, '\0');
-    in.read(&str[1], length);
+    return Load(filename, GonLoadOptions());
+}
+
+GonObject GonObject::LoadFromBuffer(const std::string& buffer){
+    return LoadFromBuffer(buffer, GonLoadOptions());
+}
+
+GonObject GonObject::Load(const std::string& filename, std::pmr::memory_resource* resource){
+    GonLoadOptions options;
+    options.resource = resource;
+    return Load(filename, options);
+}
+
+GonObject GonObject::LoadFromBuffer(const std::string& buffer, std::pmr::memory_resource* resource){
+    GonLoadOptions options;
+    options.resource = resource;
+    return LoadFromBuffer(buffer, options);
+}
+
+GonObject GonObject::Load(const std::string& filename, const GonLoadOptions& options){
+    std::string str;
+    std::streamoff length;
+    {
+        GonStatsPhase read_phase(LoadStats(options), "read", &GonStats::read_seconds);
+        std::ifstream in(filename.c_str(), std::ios::binary);
+        in.seekg (0, std::ios::end);
+        length = in.tellg();
+        in.seekg (0, std::ios::beg);
+        str.assign(length + 2, '\0');
+        in.read(&str[1], length);
+        str.front() = '{';
+        str.back() = '}';
+    }
+
+    if(options.includes && options.source.empty()){
+        GonLoadOptions file_options = options;
+        file_options.source = filename;
+        return LoadFromText(std::string_view(str).substr(1, length), &str, file_options);
+    }
+    return LoadFromText(std::string_view(str).substr(1, length), &str, options);
+}
+
+//INCLUDES
+
+//a parsed file, with its own includes left unresolved
+struct GonIncludeFragment {
+    GonObject tree;
+    bool includes; //whether tree has any ".include" fields, the ones that don't are just copied
+};
+
+struct GonIncludeEntry {
+    std::filesystem::file_time_type mtime;
+    uintmax_t size;
+    uint64_t hash;
+    double seconds; //reading and parsing it
+    std::shared_ptr<const GonIncludeFragment> fragment;
+};
+
+struct GonIncludeCacheState {
+    std::mutex mutex;
+    std::unordered_map<std::string, GonIncludeEntry> entries;
+    GonIncludeCacheStats stats;
+};
+static GonIncludeCacheState& IncludeCache(){
+    static GonIncludeCacheState cache;
+    return cache;
+}
+
+//FNV-1a
+static uint64_t HashBytes(std::string_view data){
+    uint64_t hash = 14695981039346656037ull;
+    for(char c : data){
+        hash ^= (unsigned char)c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static bool HasIncludes(const GonObject& obj){
+    if(obj.type == GonObject::FieldType::OBJECT && obj.Contains(".include")) return true;
+    for(const GonObject& child : obj.children_array){
+        if(HasIncludes(child)) return true;
+    }
+    return false;
+}
+
+//the parsed file at path (a full path), from the cache if the file hasn't changed, null if it can't be read
+static std::shared_ptr<const GonIncludeFragment> LoadFragment(const std::string& path, const GonLoadOptions& options){
+    std::error_code ec;
+    std::filesystem::file_time_type mtime = std::filesystem::last_write_time(path, ec);
+    if(ec) return nullptr;
+    uintmax_t size = std::filesystem::file_size(path, ec);
+    if(ec) return nullptr;
+
+    GonIncludeCacheState& cache = IncludeCache();
+    bool cached = false;
+    uint64_t cached_hash = 0;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto iter = cache.entries.find(path);
+        if(iter != cache.entries.end()){
+            if(iter->second.mtime == mtime && iter->second.size == size){
+                cache.stats.hits++;
+                cache.stats.saved_seconds += iter->second.seconds;
+                return iter->second.fragment;
+            }
+            cached = true;
+            cached_hash = iter->second.hash;
+        }
+    }
+
+    double start = StatsClock();
+    std::ifstream in(path.c_str(), std::ios::binary);
+    std::string str((size_t)size + 2, '\0');
+    in.read(&str[1], (std::streamsize)size);
+    if(!in) return nullptr;
     str.front() = '{';
     str.back() = '}';
+    std::string_view data = std::string_view(str).substr(1, (size_t)size);
+    uint64_t hash = HashBytes(data);
+
+    //touched but not changed
+    if(cached && hash == cached_hash){
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto iter = cache.entries.find(path);
+        if(iter != cache.entries.end() && iter->second.hash == hash){
+            iter->second.mtime = mtime;
+            cache.stats.hits++;
+            cache.stats.saved_seconds += iter->second.seconds;
+            return iter->second.fragment;
+        }
+    }
 
-    std::vector<std::string> Tokens = Tokenize(str);
+    //the cache outlives whatever resource the includer uses
+    GonLoadOptions fragment_options;
+    fragment_options.resource = std::pmr::new_delete_resource();
+    fragment_options.syntax = options.syntax;
+    fragment_options.stats = options.stats;
+    GonObject tree = LoadFromText(data, &str, fragment_options);
+    bool includes = HasIncludes(tree);
+    std::shared_ptr<const GonIncludeFragment> fragment = std::make_shared<const GonIncludeFragment>(GonIncludeFragment{std::move(tree), includes});
+    double seconds = StatsClock() - start;
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    GonIncludeEntry& entry = cache.entries[path];
+    entry.mtime = mtime;
+    entry.size = size;
+    entry.hash = hash;
+    entry.seconds = seconds;
+    entry.fragment = fragment;
+    cache.stats.misses++;
+    cache.stats.bytes_parsed += size;
+    cache.stats.parse_seconds += seconds;
+    return fragment;
+}
 
-    GonTokenStream ts;
-    ts.current = 0;
-    ts.Tokens = Tokens;
+static void ResolveIncludes(GonObject& obj, const std::filesystem::path& directory, std::vector<std::string>& stack, const GonLoadOptions& options);
+
+//appends copies of the fields of the files named by an ".include" field to children, resolving their own includes
+//stack holds the full paths of the files being included into, outermost first
+static void SpliceIncludes(std::pmr::vector<GonObject>& children, const GonObject& include, const std::filesystem::path& directory, std::vector<std::string>& stack, const GonLoadOptions& options){
+    for(const GonObject& file : include){
+        if(file.type != GonObject::FieldType::STRING){
+            GonObject::ErrorCallback("GON ERROR: .include needs a file name or an array of file names");
+            continue;
+        }
+
+        std::error_code ec;
+        std::filesystem::path path = directory / std::string(file.string_data);
+        std::filesystem::path full = std::filesystem::weakly_canonical(path, ec);
+        std::string full_path = (ec ? path.lexically_normal() : full).string();
+
+        if(std::find(stack.begin(), stack.end(), full_path) != stack.end()){
+            std::string cycle;
+            for(auto iter = std::find(stack.begin(), stack.end(), full_path); iter != stack.end(); ++iter) cycle += *iter + " -> ";
+            GonObject::ErrorCallback("GON ERROR: include cycle "+cycle+full_path);
+            continue;
+        }
+
+        std::shared_ptr<const GonIncludeFragment> fragment = LoadFragment(full_path, options);
+        if(!fragment){
+            GonObject::ErrorCallback("GON ERROR: could not include \""+full_path+"\"");
+            continue;
+        }
+        if(fragment->tree.type != GonObject::FieldType::OBJECT){
+            GonObject::ErrorCallback("GON ERROR: included file \""+full_path+"\" is not an object");
+            continue;
+        }
 
-    return LoadFromTokens(ts);
+        //fields are copied straight into the includer's storage
+        size_t needed = children.size() + fragment->tree.children_array.size();
+        if(children.capacity() < needed) children.reserve(std::max(needed, children.capacity()*2));
+        if(!fragment->includes){
+            for(const GonObject& field : fragment->tree.children_array) children.emplace_back(field);
+            continue;
+        }
+
+        stack.push_back(full_path);
+        std::filesystem::path fragment_directory = std::filesystem::path(full_path).parent_path();
+        for(const GonObject& field : fragment->tree.children_array){
+            if(field.name == ".include"){
+                SpliceIncludes(children, field, fragment_directory, stack, options);
+            } else {
+                children.emplace_back(field);
+                ResolveIncludes(children.back(), fragment_directory, stack, options);
+            }
+        }
+        stack.pop_back();
+    }
 }
 
-GonObject GonObject::LoadFromBuffer(const std::string& buffer){
-    std::string str = std::string("{")+buffer+"}";
-    std::vector<std::string> Tokens = Tokenize(str);
+static void ResolveIncludes(GonObject& obj, const std::filesystem::path& directory, std::vector<std::string>& stack, const GonLoadOptions& options){
+    for(GonObject& child : obj.children_array){
+        if(child.type == GonObject::FieldType::OBJECT || child.type == GonObject::FieldType::ARRAY) ResolveIncludes(child, directory, stack, options);
+    }
+    if(obj.type != GonObject::FieldType::OBJECT || !obj.Contains(".include")) return;
 
-    GonTokenStream ts;
-    ts.current = 0;
-    ts.Tokens = Tokens;
+    std::pmr::vector<GonObject> children(obj.children_array.get_allocator());
+    for(GonObject& child : obj.children_array){
+        if(child.name == ".include") SpliceIncludes(children, child, directory, stack, options);
+        else children.push_back(std::move(child));
+    }
 
-    return LoadFromTokens(ts);
+    obj.children_array = std::move(children);
+    obj.children_map.clear();
+    for(int i = 0; i<(int)obj.children_array.size(); i++){
+        obj.children_map[obj.children_array[i].name] = i;
+    }
+}
+
+static void ResolveDocumentIncludes(GonObject& doc, const GonLoadOptions& options){
+    std::vector<std::string> stack;
+    std::filesystem::path directory;
+    if(!options.source.empty()){
+        std::error_code ec;
+        std::filesystem::path source = std::filesystem::weakly_canonical(options.source, ec);
+        if(ec) source = std::filesystem::path(options.source).lexically_normal();
+        stack.push_back(source.string());
+        directory = source.parent_path();
+    }
+    ResolveIncludes(doc, directory, stack, options);
+}
+
+GonIncludeCacheStats GonIncludeCache::Stats(){
+    GonIncludeCacheState& cache = IncludeCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.stats;
+}
+void GonIncludeCache::ResetStats(){
+    GonIncludeCacheState& cache = IncludeCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.stats = GonIncludeCacheStats();
+}
+size_t GonIncludeCache::Size(){
+    GonIncludeCacheState& cache = IncludeCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.entries.size();
+}
+void GonIncludeCache::Clear(){
+    GonIncludeCacheState& cache = IncludeCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.entries.clear();
+}
+
+GonObject GonObject::LoadFromBuffer(const std::string& buffer, const GonLoadOptions& options){
+    return LoadFromText(buffer, nullptr, options);
 }
 
 //options with error throwing
 std::string GonObject::String() const {
-    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" does not exist");
-    if(type != FieldType::STRING && type != FieldType::NUMBER && type != FieldType::BOOL) ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" is not a string");
-    return string_data;
+    ProfileRead(*this);
+    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" does not exist");
+    if(type != FieldType::STRING && type != FieldType::NUMBER && type != FieldType::BOOL) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" is not a string");
+    return std::string(string_data);
 }
 const char* GonObject::CString() const {
-    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" does not exist");
-    if(type != FieldType::STRING && type != FieldType::NUMBER && type != FieldType::BOOL) ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" is not a string");
+    ProfileRead(*this);
+    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" does not exist");
+    if(type != FieldType::STRING && type != FieldType::NUMBER && type != FieldType::BOOL) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" is not a string");
     return string_data.c_str();
 }
 
 int GonObject::Int() const {
-    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" does not exist");
-    if(type != FieldType::NUMBER) ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" is not a number");
+    ProfileRead(*this);
+    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" does not exist");
+    if(type != FieldType::NUMBER) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" is not a number");
+    return (int)int_data;
+}
+int64_t GonObject::Int64() const {
+    ProfileRead(*this);
+    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" does not exist");
+    if(type != FieldType::NUMBER) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" is not a number");
     return int_data;
 }
 double GonObject::Number() const {
-    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" does not exist");
-    if(type != FieldType::NUMBER) ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" is not a number");
+    ProfileRead(*this);
+    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" does not exist");
+    if(type != FieldType::NUMBER) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" is not a number");
     return float_data;
 }
 double GonObject::Percent() const {
-    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" does not exist");
+    ProfileRead(*this);
+    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" does not exist");
     if(type == FieldType::NUMBER) return float_data; //should this be divided by 100 as well?
     if(type == FieldType::STRING){
-        std::string pstr = string_data;
+        std::string pstr(string_data);
         if(pstr.back() == '%'){
             remove_suffix(pstr, (std::string)"%");
             char* endptr;
@@ -303,39 +1371,50 @@ double GonObject::Percent() const {
             }
         }
     }
-    ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" is not a percent");
+    ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" is not a percent");
     return 0;
 }
 bool GonObject::Bool() const {
-    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" does not exist");
-    if(type != FieldType::BOOL) ErrorCallback("GON ERROR: Field \""+(!name.empty()?name:last_accessed_named_field)+"\" is not a bool");
+    ProfileRead(*this);
+    if(type == FieldType::NULLGON) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" does not exist");
+    if(type != FieldType::BOOL) ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" is not a bool");
     return bool_data;
 }
 
 //options with a default value
 std::string GonObject::String(const std::string& _default) const {
+    ProfileRead(*this);
     if(type != FieldType::STRING && type != FieldType::NUMBER && type != FieldType::BOOL) return _default;
-    return string_data;
+    return std::string(string_data);
 }
 const char* GonObject::CString(const char* _default) const {
+    ProfileRead(*this);
     if(type != FieldType::STRING && type != FieldType::NUMBER && type != FieldType::BOOL) return _default;
     return string_data.c_str();
 }
 
 int GonObject::Int(int _default) const {
+    ProfileRead(*this);
+    if(type != FieldType::NUMBER) return _default;
+    return (int)int_data;
+}
+int64_t GonObject::Int64(int64_t _default) const {
+    ProfileRead(*this);
     if(type != FieldType::NUMBER) return _default;
     return int_data;
 }
 double GonObject::Number(double _default) const {
+    ProfileRead(*this);
     if(type != FieldType::NUMBER) return _default;
     return float_data;
 }
 double GonObject::Percent(double _default) const {
+    ProfileRead(*this);
     if(type == FieldType::NULLGON) return _default;
     if(type == FieldType::NUMBER) return float_data; //should this be divided by 100 as well?
     if(type == FieldType::STRING){
         if(string_data.back() == '%'){
-            std::string pstr = string_data;
+            std::string pstr(string_data);
             remove_suffix(pstr, (std::string)"%");
             char* endptr;
             double res = strtod(pstr.c_str(), &endptr); //todo: switch to strtod_l instead of the remove suffix hack
@@ -347,21 +1426,22 @@ double GonObject::Percent(double _default) const {
     return _default;
 }
 bool GonObject::Bool(bool _default) const {
+    ProfileRead(*this);
     if(type != FieldType::BOOL) return _default;
     return bool_data;
 }
 
-bool GonObject::Contains(const std::string& child) const{
+bool GonObject::Contains(std::string_view child) const{
     if(type != FieldType::OBJECT) return false;
 
-    auto iter = children_map.find(child);
+    auto iter = children_map.find(MapKey(child).key);
     if(iter != children_map.end()){
         return true;
     }
 
     return false;
 }
-bool GonObject::ContainsNthChildWithName(const std::string& child, int index) const {
+bool GonObject::ContainsNthChildWithName(std::string_view child, int index) const {
     if(type != FieldType::OBJECT) return false;
 
     if(index == 0) return Contains(child);
@@ -386,7 +1466,7 @@ bool GonObject::Exists() const{
 }
 bool GonObject::IsPercent() const{
     if(type == FieldType::STRING){
-        std::string pstr = string_data;
+        std::string pstr(string_data);
         if(pstr.back() == '%'){
             remove_suffix(pstr, (std::string)"%");
             char* endptr;
@@ -400,79 +1480,107 @@ bool GonObject::IsPercent() const{
 }
 
 
-const GonObject& GonObject::ChildOrSelf(const std::string& child) const{
+const GonObject& GonObject::ChildOrSelf(std::string_view child) const{
     if(Contains(child)) return (*this)[child];
+    ProfileLookup(*this, nullptr, child);
     return *this;
 }
-GonObject& GonObject::ChildOrSelf(const std::string& child){
+GonObject& GonObject::ChildOrSelf(std::string_view child){
     if(Contains(child)) return (*this)[child];
+    ProfileLookup(*this, nullptr, child);
     return *this;
 }
 
-const GonObject& GonObject::NthChildWithName(const std::string& child, int index) const {
+const GonObject& GonObject::NthChildWithName(std::string_view child, int index) const {
     last_accessed_named_field = child;
     if(type == FieldType::NULLGON) return null_gon;
-    if(type != FieldType::OBJECT) return null_gon;
+    if(type != FieldType::OBJECT){
+        ProfileLookup(*this, nullptr, child);
+        return null_gon;
+    }
 
     if(index == 0) return (*this)[child];
 
     for(auto& entry : children_array) {
         if(entry.name == child) {
-            if(index-- == 0) return entry;
+            if(index-- == 0){
+                ProfileLookup(*this, &entry, child);
+                return entry;
+            }
         }
     }
 
+    ProfileLookup(*this, nullptr, child);
     return null_gon;
 }
-GonObject& GonObject::NthChildWithName(const std::string& child, int index) {
+GonObject& GonObject::NthChildWithName(std::string_view child, int index) {
     last_accessed_named_field = child;
     if(type == FieldType::NULLGON) return non_const_null_gon;
-    if(type != FieldType::OBJECT) return non_const_null_gon;
+    if(type != FieldType::OBJECT){
+        ProfileLookup(*this, nullptr, child);
+        return non_const_null_gon;
+    }
 
     if(index == 0) return (*this)[child];
 
     for(auto& entry : children_array) {
         if(entry.name == child) {
-            if(index-- == 0) return entry;
+            if(index-- == 0){
+                ProfileLookup(*this, &entry, child);
+                return entry;
+            }
         }
     }
 
+    ProfileLookup(*this, nullptr, child);
     return non_const_null_gon;
 }
 
-const GonObject& GonObject::FieldInChildOrSelf(const std::string& child, const std::string& field) const {
-    if((*this)[child][field].Exists()) return (*this)[child][field];
+const GonObject& GonObject::FieldInChildOrSelf(std::string_view child, std::string_view field) const {
+    const GonObject& res = (*this)[child][field];
+    if(res.Exists()) return res;
     return (*this)[field];
 }
-GonObject& GonObject::FieldInChildOrSelf(const std::string& child, const std::string& field) {
-    if((*this)[child][field].Exists()) return (*this)[child][field];
+GonObject& GonObject::FieldInChildOrSelf(std::string_view child, std::string_view field) {
+    GonObject& res = (*this)[child][field];
+    if(res.Exists()) return res;
     return (*this)[field];
 }
 
-const GonObject& GonObject::operator[](const std::string& child) const {
+const GonObject& GonObject::operator[](std::string_view child) const {
     last_accessed_named_field = child;
 
     if(type == FieldType::NULLGON) return null_gon;
-    if(type != FieldType::OBJECT) return null_gon;
+    if(type != FieldType::OBJECT){
+        ProfileLookup(*this, nullptr, child);
+        return null_gon;
+    }
 
-    auto iter = children_map.find(child);
+    auto iter = children_map.find(MapKey(child).key);
     if(iter != children_map.end()){
+        ProfileLookup(*this, &children_array[iter->second], child);
         return children_array[iter->second];
     }
 
+    ProfileLookup(*this, nullptr, child);
     return null_gon;
 }
-GonObject& GonObject::operator[](const std::string& child) {
+GonObject& GonObject::operator[](std::string_view child) {
     last_accessed_named_field = child;
 
     if(type == FieldType::NULLGON) return non_const_null_gon;
-    if(type != FieldType::OBJECT) return non_const_null_gon;
+    if(type != FieldType::OBJECT){
+        ProfileLookup(*this, nullptr, child);
+        return non_const_null_gon;
+    }
 
-    auto iter = children_map.find(child);
+    auto iter = children_map.find(MapKey(child).key);
     if(iter != children_map.end()){
+        ProfileLookup(*this, &children_array[iter->second], child);
         return children_array[iter->second];
     }
 
+    ProfileLookup(*this, nullptr, child);
     return non_const_null_gon;
 }
 const GonObject& GonObject::operator[](int childindex) const {
@@ -535,15 +1643,17 @@ void GonObject::DebugOut() const {
     }
 
     if(type == FieldType::STRING){
-        std::cout << name << " is string \"" << String() << "\"" << std::endl;
+        std::cout << name << " is string \"" << string_data << "\"" << std::endl;
     }
 
     if(type == FieldType::NUMBER){
-        std::cout << name << " is number " << Int() << std::endl;
+        std::string number;
+        AppendNumber(number, int_data, float_data);
+        std::cout << name << " is number " << number << std::endl;
     }
 
     if(type == FieldType::BOOL){
-        std::cout << name << " is bool " << Bool()<< std::endl;
+        std::cout << name << " is bool " << bool_data << std::endl;
     }
 
     if(type == FieldType::NULLGON){
@@ -551,7 +1661,7 @@ void GonObject::DebugOut() const {
     }
 }
 
-static std::string escaped_string(std::string input){
+static std::string escaped_string(std::string_view input){
     auto tokenized = Tokenize(input);
     bool needs_quotes = tokenized.size() != 1 || tokenized[0] != input;
 
@@ -575,6 +1685,83 @@ static std::string escaped_string(std::string input){
     return out_str;
 }
 
+GonMemoryUsage& GonMemoryUsage::operator+=(const GonMemoryUsage& other){
+    nodes += other.nodes;
+    strings += other.strings;
+    hash_tables += other.hash_tables;
+    vector_slack += other.vector_slack;
+    return *this;
+}
+
+//secondary indexes of one object (see BuildIndex)
+struct GonIndexes {
+    struct Index {
+        std::string path;
+        std::vector<std::string> fields; //path split at the dots
+        std::unordered_map<std::string, std::vector<int>> children; //value -> positions in children_array, in order
+    };
+    std::vector<Index> list;
+
+    Index* Find(std::string_view path){
+        for(Index& index : list) if(index.path == path) return &index;
+        return nullptr;
+    }
+};
+
+//short strings are stored inside the string object itself
+template<class String>
+static size_t string_heap_bytes(const String& str){
+    const char* inside = (const char*)&str;
+    if(str.data() >= inside && str.data() < inside+sizeof(str)) return 0;
+    return str.capacity()+1;
+}
+
+GonMemoryUsage GonObject::MemoryUsage() const {
+    GonMemoryUsage res;
+    res.nodes = sizeof(GonObject);
+    res.strings = string_heap_bytes(name) + string_heap_bytes(string_data);
+
+    //node based map: a bucket array plus one allocation per entry holding the next pointer, the key/value pair and the cached hash
+    if(children_map.bucket_count() > 1) res.hash_tables += children_map.bucket_count()*sizeof(void*);
+    for(const auto& entry : children_map){
+        res.hash_tables += sizeof(void*) + sizeof(entry) + sizeof(size_t) + string_heap_bytes(entry.first);
+    }
+
+    if(indexes.indexes){
+        for(const GonIndexes::Index& index : indexes.indexes->list){
+            if(index.children.bucket_count() > 1) res.hash_tables += index.children.bucket_count()*sizeof(void*);
+            for(const auto& entry : index.children){
+                res.hash_tables += sizeof(void*) + sizeof(entry) + sizeof(size_t) + string_heap_bytes(entry.first) + entry.second.capacity()*sizeof(int);
+            }
+        }
+    }
+
+    res.vector_slack = (children_array.capacity() - children_array.size())*sizeof(GonObject);
+    for(const GonObject& child : children_array){
+        res += child.MemoryUsage();
+    }
+    return res;
+}
+
+void GonObject::Compact(){
+    name.shrink_to_fit();
+    string_data.shrink_to_fit();
+    children_array.shrink_to_fit();
+
+    std::pmr::unordered_map<std::pmr::string, int> fresh(get_allocator());
+    if(type == FieldType::OBJECT){
+        fresh.reserve(children_map.size());
+        for(int i = 0; i<(int)children_array.size(); i++){
+            fresh[children_array[i].name] = i;
+        }
+    }
+    children_map.swap(fresh);
+
+    for(GonObject& child : children_array){
+        child.Compact();
+    }
+}
+
 void GonObject::Save(const std::string& filename) const {
     std::ofstream outfile(filename);
     outfile << SaveToStr(false);
@@ -614,7 +1801,7 @@ std::string GonObject::GetOutStr(const std::string& tab, const std::string& line
                 short_array = false;
 
             if(children_array[i].type == GonObject::FieldType::STRING)
-                strlengthtotal += children_array[i].String().size();
+                strlengthtotal += children_array[i].string_data.size(); //not String(), saving shouldn't show up as reads in the access profiler
 
 
             if(!short_array) break;
@@ -639,15 +1826,15 @@ std::string GonObject::GetOutStr(const std::string& tab, const std::string& line
     }
 
     if(type == FieldType::STRING){
-        out += escaped_string(String());
+        out += escaped_string(string_data);
     }
 
     if(type == FieldType::NUMBER){
-        out += std::to_string(Int());
+        AppendNumber(out, int_data, float_data);
     }
 
     if(type == FieldType::BOOL){
-        if(Bool()){
+        if(bool_data){
             out += "true";
         } else {
             out += "false";
@@ -664,7 +1851,7 @@ std::string GonObject::GetOutStr(const std::string& tab, const std::string& line
 
 //COMBINING/PATCHING/MERGING STUFF
 
-static GonObject::MergeMode get_patchmode(const std::string& str){
+static GonObject::MergeMode get_patchmode(std::string_view str){
     GonObject::MergeMode policy = GonObject::MergeMode::DEFAULT;
     if(ends_with(str, ".overwrite")){
         policy = GonObject::MergeMode::OVERWRITE;
@@ -680,8 +1867,8 @@ static GonObject::MergeMode get_patchmode(const std::string& str){
     return policy;
 }
 
-static std::string remove_patch_suffixes(const std::string& str){
-    std::string res = str;
+static std::pmr::string remove_patch_suffixes(std::string_view str){
+    std::pmr::string res(str);
     remove_suffix(res, ".overwrite");
     remove_suffix(res, ".append");
     remove_suffix(res, ".merge");
@@ -710,11 +1897,63 @@ static void remove_patch_suffixes_recursive(GonObject& obj){
     }
 }
 
-static bool has_patch_suffixes(const std::string& str){
+static bool has_patch_suffixes(std::string_view str){
     return get_patchmode(str) != GonObject::MergeMode::DEFAULT;
 }
 
 
+static bool AddInt64(int64_t a, int64_t b, int64_t& out){
+    if((b > 0 && a > INT64_MAX - b) || (b < 0 && a < INT64_MIN - b)) return false;
+    out = a + b;
+    return true;
+}
+static bool MultiplyInt64(int64_t a, int64_t b, int64_t& out){
+    if(a == 0 || b == 0){
+        out = 0;
+        return true;
+    }
+    if((a == -1 && b == INT64_MIN) || (b == -1 && a == INT64_MIN)) return false;
+    int64_t res = (int64_t)((uint64_t)a * (uint64_t)b);
+    if(res / b != a) return false;
+    out = res;
+    return true;
+}
+
+static void SetNumber(GonObject& obj, int64_t int_value, double float_value){
+    obj.int_data = int_value;
+    obj.float_data = float_value;
+    obj.string_data.clear();
+    AppendNumber(obj.string_data, int_value, float_value);
+    obj.bool_data = float_value != 0;
+}
+
+//.add and .multiply stay exact while both sides are integers (and don't overflow), otherwise they are done in double precision
+static void MergeNumbers(GonObject& self, const GonObject& other, GonObject::MergeMode policy){
+    bool integers = self.float_data == (double)self.int_data && other.float_data == (double)other.int_data;
+    int64_t int_result;
+
+    if(policy == GonObject::MergeMode::ADD){
+        if(integers && AddInt64(self.int_data, other.int_data, int_result)){
+            SetNumber(self, int_result, (double)int_result);
+        } else {
+            double res = self.float_data + other.float_data;
+            SetNumber(self, DoubleToInt64(res), res);
+        }
+    } else if(policy == GonObject::MergeMode::MULTIPLY){
+        if(integers && MultiplyInt64(self.int_data, other.int_data, int_result)){
+            SetNumber(self, int_result, (double)int_result);
+        } else {
+            double res = self.float_data * other.float_data;
+            SetNumber(self, DoubleToInt64(res), res);
+        }
+    } else {
+        self.float_data = other.float_data;
+        self.int_data = other.int_data;
+        self.string_data = other.string_data;
+        self.bool_data = other.bool_data;
+    }
+}
+
 GonObject::MergeMode GonObject::MergePolicyAppend(const GonObject& field_a, const GonObject& field_b){
     return MergeMode::APPEND;
 }
@@ -725,11 +1964,133 @@ GonObject::MergeMode GonObject::MergePolicyOverwrite(const GonObject& field_a, c
     return MergeMode::OVERWRITE;
 }
 
+//SECONDARY INDEXES (GonIndexes is defined above MemoryUsage)
+
+GonIndexHandle::GonIndexHandle(){
+}
+GonIndexHandle::GonIndexHandle(const GonIndexHandle&){
+}
+GonIndexHandle::GonIndexHandle(GonIndexHandle&& other) noexcept:indexes(std::move(other.indexes)){
+}
+GonIndexHandle& GonIndexHandle::operator=(const GonIndexHandle&){
+    indexes.reset();
+    return *this;
+}
+GonIndexHandle& GonIndexHandle::operator=(GonIndexHandle&& other) noexcept {
+    indexes = std::move(other.indexes);
+    return *this;
+}
+GonIndexHandle::~GonIndexHandle(){
+}
+
+//like chained operator[], without touching last_accessed_named_field
+static const GonObject& IndexedField(const GonObject& child, const std::vector<std::string>& fields){
+    const GonObject* field = &child;
+    for(const std::string& name : fields){
+        if(field->type != GonObject::FieldType::OBJECT) return GonObject::null_gon;
+        auto iter = field->children_map.find(MapKey(name).key);
+        if(iter == field->children_map.end()) return GonObject::null_gon;
+        field = &field->children_array[iter->second];
+    }
+    return *field;
+}
+
+static void IndexChildren(GonIndexes::Index& index, const GonObject& obj, int first){
+    for(int i = first; i<(int)obj.children_array.size(); i++){
+        const GonObject& field = IndexedField(obj.children_array[i], index.fields);
+        if(field.type == GonObject::FieldType::STRING || field.type == GonObject::FieldType::NUMBER || field.type == GonObject::FieldType::BOOL){
+            index.children[std::string(field.string_data)].push_back(i);
+        }
+    }
+}
+
+//children added from position first on are added to every index
+static void IndexNewChildren(GonObject& obj, int first){
+    if(!obj.indexes.indexes) return;
+    for(GonIndexes::Index& index : obj.indexes.indexes->list){
+        IndexChildren(index, obj, first);
+    }
+}
+
+//the merge functions change children in place, so indexes are set aside while merging and rebuilt once at the end
+//(set aside rather than dropped, since merges can assign over the whole object)
+struct GonReindexAfterMerge {
+    GonObject& obj;
+    std::unique_ptr<GonIndexes> saved;
+
+    GonReindexAfterMerge(GonObject& obj):obj(obj),saved(std::move(obj.indexes.indexes)){
+    }
+    ~GonReindexAfterMerge(){
+        if(!saved) return;
+        for(GonIndexes::Index& index : saved->list){
+            index.children.clear();
+            IndexChildren(index, obj, 0);
+        }
+        obj.indexes.indexes = std::move(saved);
+    }
+};
+
+void GonObject::BuildIndex(std::string_view path){
+    if(!indexes.indexes) indexes.indexes.reset(new GonIndexes());
+
+    GonIndexes::Index* index = indexes.indexes->Find(path);
+    if(!index){
+        indexes.indexes->list.emplace_back();
+        index = &indexes.indexes->list.back();
+        index->path = path;
+        for(size_t start = 0; !path.empty() && start <= path.size();){
+            size_t dot = std::min(path.find('.', start), path.size());
+            index->fields.push_back(std::string(path.substr(start, dot-start)));
+            start = dot+1;
+        }
+    }
+
+    index->children.clear();
+    if(type == FieldType::OBJECT || type == FieldType::ARRAY) IndexChildren(*index, *this, 0);
+}
+void GonObject::DropIndex(std::string_view path){
+    if(!indexes.indexes) return;
+    std::vector<GonIndexes::Index>& list = indexes.indexes->list;
+    for(size_t i = 0; i<list.size(); i++){
+        if(list[i].path == path){
+            list.erase(list.begin() + i);
+            break;
+        }
+    }
+    if(list.empty()) indexes.indexes.reset();
+}
+bool GonObject::HasIndex(std::string_view path) const {
+    return indexes.indexes && indexes.indexes->Find(path);
+}
+
+const std::vector<int>& GonObject::FindAll(std::string_view path, std::string_view value) const {
+    static const std::vector<int> none;
+
+    GonIndexes::Index* index = indexes.indexes ? indexes.indexes->Find(path) : nullptr;
+    if(!index){
+        ErrorCallback("GON ERROR: Field \""+field_name(*this)+"\" has no index on \""+std::string(path)+"\"");
+        return none;
+    }
+    auto iter = index->children.find(std::string(value));
+    if(iter == index->children.end()) return none;
+    return iter->second;
+}
+const GonObject& GonObject::FindFirst(std::string_view path, std::string_view value) const {
+    const std::vector<int>& found = FindAll(path, value);
+    if(found.empty()) return null_gon;
+    return children_array[found[0]];
+}
+GonObject& GonObject::FindFirst(std::string_view path, std::string_view value){
+    const std::vector<int>& found = FindAll(path, value);
+    if(found.empty()) return non_const_null_gon;
+    return children_array[found[0]];
+}
+
 
 void GonObject::InsertChild(const GonObject& other){
     InsertChild(other.name, other);
 }
-void GonObject::InsertChild(std::string cname, const GonObject& other){
+void GonObject::InsertChild(std::string_view cname, const GonObject& other){
     if(type == FieldType::NULLGON){
         type = FieldType::OBJECT;
     }
@@ -737,17 +2098,21 @@ void GonObject::InsertChild(std::string cname, const GonObject& other){
     if(type == FieldType::OBJECT){
         children_array.push_back(other);
         children_array.back().name = cname;
-        children_map[cname] = (int)children_array.size() - 1;
+        children_map[std::pmr::string(cname, children_map.get_allocator())] = (int)children_array.size() - 1;
     } else if(type == FieldType::ARRAY){
         children_array.push_back(other);
         children_array.back().name = "";
     } else {
         ErrorCallback("GON ERROR: Inserting onto incompatible types");
+        return;
     }
+    IndexNewChildren(*this, (int)children_array.size() - 1);
 }
 
 
 void GonObject::Append(const GonObject& other){
+    GonStatsMerge merge_stats(*this);
+    int first_new = (int)children_array.size();
     if(type == FieldType::NULLGON){
         *this = other;
     } if(type == FieldType::OBJECT && other.type == FieldType::OBJECT){
@@ -764,16 +2129,19 @@ void GonObject::Append(const GonObject& other){
     } else {
         ErrorCallback("GON ERROR: Append incompatible types");
     }
+    IndexNewChildren(*this, first_new);
 }
 
 void GonObject::ShallowMerge(const GonObject& other, std::function<void(const GonObject& a, const GonObject& b)> OnOverwrite){
+    GonStatsMerge merge_stats(*this);
+    GonReindexAfterMerge reindex(*this);
     if(type == FieldType::NULLGON){
         *this = other;
     } else if(type == FieldType::OBJECT && other.type == FieldType::OBJECT){
-        std::unordered_map<std::string, int> field_counts; //todo: do this with less allocations
+        std::unordered_map<std::pmr::string, int> field_counts; //todo: do this with less allocations
 
         for(int i = 0; i<other.size(); i++){
-            const std::string& fieldname = other[i].name;
+            const std::pmr::string& fieldname = other[i].name;
 
             if(ContainsNthChildWithName(fieldname, field_counts[fieldname])){
                 GonObject& myfield = NthChildWithName(fieldname, field_counts[fieldname]);
@@ -797,6 +2165,8 @@ void GonObject::ShallowMerge(const GonObject& other, std::function<void(const Go
 
 
 void GonObject::DeepMerge(const GonObject& other, MergePolicyCallback ObjectMergePolicy, MergePolicyCallback ArrayMergePolicy){
+    GonStatsMerge merge_stats(*this);
+    GonReindexAfterMerge reindex(*this);
     MergeMode policy = ObjectMergePolicy(*this, other);
 
     if(type == FieldType::OBJECT && other.type == FieldType::OBJECT){
@@ -806,10 +2176,10 @@ void GonObject::DeepMerge(const GonObject& other, MergePolicyCallback ObjectMerg
                 children_map[other[i].name] = (int)children_array.size() - 1;
             }
         } else if(policy == MergeMode::MERGE || policy == MergeMode::DEFAULT || policy == MergeMode::MULTIPLY) {
-            std::unordered_map<std::string, int> field_counts; //todo: do this with less allocations
+            std::unordered_map<std::pmr::string, int> field_counts; //todo: do this with less allocations
 
             for(int i = 0; i<other.size(); i++){
-                const std::string& fieldname = other[i].name;
+                const std::pmr::string& fieldname = other[i].name;
 
                 if(ContainsNthChildWithName(fieldname, field_counts[fieldname])) {
                     NthChildWithName(fieldname, field_counts[fieldname]).DeepMerge(other[i], ObjectMergePolicy, ArrayMergePolicy);
@@ -845,30 +2215,7 @@ void GonObject::DeepMerge(const GonObject& other, MergePolicyCallback ObjectMerg
             string_data = other.string_data;
         }
     } else if(type == FieldType::NUMBER && other.type == FieldType::NUMBER){
-        if(policy == MergeMode::ADD){
-            float_data += other.float_data;
-            int_data = int(float_data);
-            if(float_data == int_data){
-                string_data = std::to_string(int_data);
-            } else {
-                string_data = std::to_string(float_data);
-            }
-            bool_data = float_data != 0;
-        } else if(policy == MergeMode::MULTIPLY){
-            float_data *= other.float_data;
-            int_data = int(float_data);
-            if(float_data == int_data){
-                string_data = std::to_string(int_data);
-            } else {
-                string_data = std::to_string(float_data);
-            }
-            bool_data = float_data != 0;
-        } else {
-            float_data = other.float_data;
-            int_data = other.int_data;
-            string_data = other.string_data;
-            bool_data = other.bool_data;
-        }
+        MergeNumbers(*this, other, policy);
     } else {
         *this = other;
     }
@@ -876,6 +2223,8 @@ void GonObject::DeepMerge(const GonObject& other, MergePolicyCallback ObjectMerg
 
 
 void GonObject::PatchMerge(const GonObject& other){
+    GonStatsMerge merge_stats(*this);
+    GonReindexAfterMerge reindex(*this);
     MergeMode policy = get_patchmode(other.name);
 
     if(type == FieldType::OBJECT && other.type == FieldType::OBJECT){
@@ -883,11 +2232,11 @@ void GonObject::PatchMerge(const GonObject& other){
             *this = other;
             remove_patch_suffixes_recursive(*this);
         } else {
-            std::unordered_map<std::string, int> field_counts; //todo: do this with less allocations
+            std::unordered_map<std::pmr::string, int> field_counts; //todo: do this with less allocations
 
             for(int i = 0; i<other.size(); i++){
                 if(has_patch_suffixes(other[i].name)){
-                    std::string other_name = remove_patch_suffixes(other[i].name);
+                    std::pmr::string other_name = remove_patch_suffixes(other[i].name);
                     if(other_name.empty()){ //patch with self instead of child
                         PatchMerge(other[i]);
                     } else {
@@ -906,7 +2255,7 @@ void GonObject::PatchMerge(const GonObject& other){
                         remove_patch_suffixes_recursive(children_array.back());
                         children_map[other[i].name] = (int)children_array.size() - 1;
                     } else if(policy == MergeMode::MERGE || policy == MergeMode::DEFAULT || policy == MergeMode::MULTIPLY){
-                        const std::string& fieldname = other[i].name;
+                        const std::pmr::string& fieldname = other[i].name;
                         if(ContainsNthChildWithName(fieldname, field_counts[fieldname])) {
                             NthChildWithName(fieldname, field_counts[fieldname]).PatchMerge(other[i]);
                             field_counts[fieldname]++;
@@ -943,32 +2292,171 @@ void GonObject::PatchMerge(const GonObject& other){
             string_data = other.string_data;
         }
     } else if(type == FieldType::NUMBER && other.type == FieldType::NUMBER){
-        if(policy == MergeMode::ADD){
-            float_data += other.float_data;
-            int_data = int(float_data);
-            if(float_data == int_data){
-                string_data = std::to_string(int_data);
-            } else {
-                string_data = std::to_string(float_data);
-            }
-            bool_data = float_data != 0;
-        } else if(policy == MergeMode::MULTIPLY){
-            float_data *= other.float_data;
-            int_data = int(float_data);
-            if(float_data == int_data){
-                string_data = std::to_string(int_data);
-            } else {
-                string_data = std::to_string(float_data);
-            }
-            bool_data = float_data != 0;
-        } else {
-            float_data = other.float_data;
-            int_data = other.int_data;
-            string_data = other.string_data;
-            bool_data = other.bool_data;
-        }
+        MergeNumbers(*this, other, policy);
     } else {
         *this = other;
         remove_patch_suffixes_recursive(*this);
     }
 }
+
+
+//ACCESS PROFILER REPORTS
+
+#ifdef GON_ACCESS_PROFILER
+struct GonAccessReportBuilder {
+    const GonAccessCounters& counters;
+    GonAccessReport& report;
+    std::unordered_map<std::string, size_t> hottest;
+    std::unordered_map<std::string, size_t> misses;
+    std::unordered_map<std::string, size_t> unused;
+
+    GonAccessReportBuilder(const GonAccessCounters& counters, GonAccessReport& report):counters(counters),report(report){
+    }
+
+    template<class T>
+    static T& Entry(std::vector<T>& list, std::unordered_map<std::string, size_t>& lookup, const std::string& path){
+        auto inserted = lookup.emplace(path, list.size());
+        if(inserted.second){
+            list.emplace_back();
+            list.back().path = path;
+        }
+        return list[inserted.first->second];
+    }
+
+    //returns the number of nodes in the subtree, accessed is set if anything in it was looked up or read
+    uint64_t Walk(const GonObject& obj, const std::string& path, bool& accessed){
+        uint64_t subtree_nodes = 1;
+        report.nodes++;
+
+        auto counts = counters.nodes.find(&obj);
+        if(counts != counters.nodes.end()){
+            accessed = true;
+            report.accessed_nodes++;
+            GonAccessReport::Path& entry = Entry(report.hottest, hottest, path);
+            entry.lookups += counts->second.lookups;
+            entry.reads += counts->second.reads;
+            entry.nodes++;
+        }
+
+        auto missed = counters.misses.find(&obj);
+        if(missed != counters.misses.end()){
+            accessed = true; //looking for something that isn't there still uses the node
+            for(auto& key : missed->second){
+                Entry(report.misses, misses, path.empty() ? key.first : path+"."+key.first).count += key.second;
+            }
+        }
+
+        std::vector<std::pair<std::string, uint64_t>> unused_children;
+        for(const GonObject& child : obj.children_array){
+            std::string child_path;
+            if(obj.type == GonObject::FieldType::OBJECT && !child.name.empty()) child_path = path.empty() ? std::string(child.name) : path+"."+std::string(child.name);
+            else child_path = path+"[]";
+
+            bool child_accessed = false;
+            uint64_t child_nodes = Walk(child, child_path, child_accessed);
+            subtree_nodes += child_nodes;
+            if(child_accessed) accessed = true;
+            else unused_children.emplace_back(std::move(child_path), child_nodes);
+        }
+
+        //only the topmost never-accessed subtrees are listed, so they're only known once something next to them was accessed
+        if(accessed){
+            for(auto& child : unused_children){
+                GonAccessReport::Unused& entry = Entry(report.unused, unused, child.first);
+                entry.subtrees++;
+                entry.nodes += child.second;
+            }
+        }
+        return subtree_nodes;
+    }
+};
+#endif
+
+void GonAccessProfiler::Start(){
+    #ifdef GON_ACCESS_PROFILER
+    access_profiler_running = true;
+    #endif
+}
+void GonAccessProfiler::Stop(){
+    #ifdef GON_ACCESS_PROFILER
+    access_profiler_running = false;
+    #endif
+}
+bool GonAccessProfiler::Running(){
+    #ifdef GON_ACCESS_PROFILER
+    return access_profiler_running;
+    #else
+    return false;
+    #endif
+}
+void GonAccessProfiler::Reset(){
+    #ifdef GON_ACCESS_PROFILER
+    GonAccessRegistry& registry = AccessRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for(GonAccessCounters* counters : registry.threads){
+        std::lock_guard<std::mutex> counters_lock(counters->mutex);
+        counters->Clear();
+    }
+    registry.retired.Clear();
+    #endif
+}
+
+GonAccessReport GonAccessProfiler::Report([[maybe_unused]] const GonObject& root){
+    GonAccessReport report;
+    #ifdef GON_ACCESS_PROFILER
+    GonAccessCounters total;
+    {
+        GonAccessRegistry& registry = AccessRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.retired.AddTo(total);
+        for(GonAccessCounters* counters : registry.threads){
+            std::lock_guard<std::mutex> counters_lock(counters->mutex);
+            counters->AddTo(total);
+        }
+    }
+
+    GonAccessReportBuilder builder(total, report);
+    bool accessed = false;
+    uint64_t nodes = builder.Walk(root, "", accessed);
+    if(!accessed){
+        report.unused.emplace_back();
+        report.unused.back().subtrees = 1;
+        report.unused.back().nodes = nodes;
+    }
+
+    std::stable_sort(report.hottest.begin(), report.hottest.end(), [](const GonAccessReport::Path& a, const GonAccessReport::Path& b){
+        return a.lookups + a.reads > b.lookups + b.reads;
+    });
+    std::stable_sort(report.misses.begin(), report.misses.end(), [](const GonAccessReport::Miss& a, const GonAccessReport::Miss& b){
+        return a.count > b.count;
+    });
+    std::stable_sort(report.unused.begin(), report.unused.end(), [](const GonAccessReport::Unused& a, const GonAccessReport::Unused& b){
+        return a.nodes > b.nodes;
+    });
+    #endif
+    return report;
+}
+
+std::string GonAccessReport::ToString(size_t lines) const {
+    auto PathName = [](const std::string& path){
+        return path.empty() ? std::string("(root)") : path;
+    };
+
+    std::string res = "accessed "+std::to_string(accessed_nodes)+" of "+std::to_string(nodes)+" nodes\n";
+
+    res += "hottest (lookups, reads, nodes):\n";
+    for(size_t i = 0; i<hottest.size() && i<lines; i++){
+        res += "    "+PathName(hottest[i].path)+"  "+std::to_string(hottest[i].lookups)+", "+std::to_string(hottest[i].reads)+", "+std::to_string(hottest[i].nodes)+"\n";
+    }
+
+    res += "misses:\n";
+    for(size_t i = 0; i<misses.size() && i<lines; i++){
+        res += "    "+misses[i].path+"  "+std::to_string(misses[i].count)+"\n";
+    }
+
+    res += "never accessed (subtrees, nodes):\n";
+    for(size_t i = 0; i<unused.size() && i<lines; i++){
+        res += "    "+PathName(unused[i].path)+"  "+std::to_string(unused[i].subtrees)+", "+std::to_string(unused[i].nodes)+"\n";
+    }
+    return res;
+}
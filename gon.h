@@ -2,19 +2,159 @@
 //its json, minus the crap!
 
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <memory_resource>
+
+//what loads and merges spent their time and memory on, filled in when passed to a load (GonLoadOptions::stats) or made current with GonStatsScope
+//values add up over every load/merge recorded into the same GonStats, one GonStats must only be recorded into by one thread at a time
+//compiling gon.cpp with GON_NO_STATS removes all of the recording code (GonStats stays all zeros)
+struct GonStats {
+    uint64_t loads = 0;
+    uint64_t bytes_read = 0;      //document bytes
+    uint64_t tokens = 0;          //gon tokens (json documents are parsed without tokenizing)
+    uint64_t nodes = 0;           //nodes in the loaded trees
+    uint64_t numbers = 0;         //values that parsed as numbers
+    int max_depth = 0;            //deepest nesting of a loaded tree (the root is depth 0)
+
+    double read_seconds = 0;      //reading files
+    double tokenize_seconds = 0;
+    double build_seconds = 0;     //building the tree from tokens, or parsing json, including number conversion
+    double number_seconds = 0;    //the part of build_seconds spent converting values (timed per value, which adds a little to build_seconds itself)
+
+    uint64_t merges = 0;          //Append, ShallowMerge, DeepMerge and PatchMerge calls (not counting the recursive ones)
+    double merge_seconds = 0;
+
+    //only counted for trees allocated from a GonCountingResource
+    uint64_t allocations = 0;
+    uint64_t allocated_bytes = 0;
+
+    //tracing hooks, called around each phase: "parse" (a whole load, around the others except "read"), "read", "tokenize", "build", "merge"
+    std::function<void(const char* phase)> OnBegin;
+    std::function<void(const char* phase)> OnEnd;
+};
+
+//while it exists, loads and merges on this thread record into stats (loads with GonLoadOptions::stats set use that instead), scopes can nest
+class GonStatsScope {
+    public:
+        explicit GonStatsScope(GonStats& stats);
+        ~GonStatsScope();
+        GonStatsScope(const GonStatsScope&) = delete;
+        GonStatsScope& operator=(const GonStatsScope&) = delete;
+
+        static GonStats* Current(); //null if there's no scope on this thread
+
+    private:
+        GonStats* previous;
+};
+
+//passes every allocation through to upstream and counts them, use it as the resource of a load to get allocation numbers in GonStats
+//(or as an allocation hook of its own: wrap any resource, read the counters whenever)
+class GonCountingResource : public std::pmr::memory_resource {
+    public:
+        explicit GonCountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+        uint64_t Allocations() const;
+        uint64_t AllocatedBytes() const;
+        uint64_t Deallocations() const;
+        uint64_t BytesInUse() const;
+        uint64_t PeakBytesInUse() const;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        std::pmr::memory_resource* upstream;
+        std::atomic<uint64_t> allocations;
+        std::atomic<uint64_t> allocated_bytes;
+        std::atomic<uint64_t> deallocations;
+        std::atomic<uint64_t> bytes_in_use;
+        std::atomic<uint64_t> peak_bytes_in_use;
+};
+
+struct GonLoadOptions {
+    enum class Syntax {
+        AUTO, //strict json when the document is a bare array or starts with '{' and a quoted key, falling back to GON if it doesn't parse as json
+        GON,
+        JSON  //strict json only, errors are reported through ErrorCallback
+    };
+
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource(); //where the tree is allocated (see Load)
+    Syntax syntax = Syntax::AUTO;
+    GonStats* stats = nullptr; //records this load (GonStatsScope::Current() if null)
+
+    //splice other files into objects with ".include" fields (see GonIncludeCache):
+    //    weapon { .include "common/weapon_stats.gon"  damage 12 }
+    //    palette { .include [colors/base.gon colors/night.gon] }
+    //the included files' fields replace the ".include" field in order, so fields after it win for operator[] like with Append
+    //paths are relative to the directory of the file doing the including, a file including itself (directly or not) is an error
+    bool includes = false;
+    std::string source; //the document's file, set by Load, relative include paths in LoadFromBuffer documents start from the working directory if empty
+};
+
+//counters for GonIncludeCache, for every load in the process
+struct GonIncludeCacheStats {
+    uint64_t hits = 0;          //includes of a fragment that was already parsed
+    uint64_t misses = 0;        //fragments read and parsed (first include, or the file changed)
+    uint64_t bytes_parsed = 0;
+    double parse_seconds = 0;   //reading and parsing fragments
+    double saved_seconds = 0;   //what reading and parsing would have taken for every hit
+};
+
+//files pulled in by ".include" are parsed once per process and kept here by full path, every includer gets a copy of the parsed tree
+//a cached fragment is reused while the file's modification time and size are unchanged, or its contents still hash the same
+//(includes inside a fragment are resolved each time it's included, so changing a nested file doesn't need the files above it touched)
+//two threads including the same uncached file at the same time may both parse it
+class GonIncludeCache {
+    public:
+        static GonIncludeCacheStats Stats();
+        static void ResetStats();
+        static size_t Size(); //cached fragments
+        static void Clear();
+};
+
+//bytes used by a subtree, heap sizes of hash table nodes depend on the standard library so that part is an estimate
+struct GonMemoryUsage {
+    size_t nodes = 0;        //sizeof(GonObject) for every node in the subtree
+    size_t strings = 0;      //heap buffers of names and values (short strings live inside the node and count as 0)
+    size_t hash_tables = 0;  //children_map and secondary index buckets, entries and key buffers
+    size_t vector_slack = 0; //unused capacity of children_array
+
+    size_t Total() const { return nodes + strings + hash_tables + vector_slack; }
+    GonMemoryUsage& operator+=(const GonMemoryUsage& other);
+};
+
+struct GonIndexes; //defined in gon.cpp
+
+//owns an object's secondary indexes (see GonObject::BuildIndex), copying leaves them behind and assigning over an object drops its own
+class GonIndexHandle {
+    public:
+        GonIndexHandle();
+        GonIndexHandle(const GonIndexHandle& other);
+        GonIndexHandle(GonIndexHandle&& other) noexcept;
+        GonIndexHandle& operator=(const GonIndexHandle& other);
+        GonIndexHandle& operator=(GonIndexHandle&& other) noexcept;
+        ~GonIndexHandle();
+
+        std::unique_ptr<GonIndexes> indexes;
+};
 
 class GonObject {
     public:
         static const GonObject null_gon;
         static GonObject non_const_null_gon;
-        static std::string last_accessed_named_field;//used for error reporting when a field is missing,
+        static thread_local std::string last_accessed_named_field;//used for error reporting when a field is missing,
                                                      //this assumes you don't cache a field then try to access it later
                                                      //as the error report for fields uses this value for its message (to avoid creating and destroying a ton of dummy-objects)
                                                      //this isn't a great or super accurate solution for errors, but it's better than nothing
+                                                     //(thread local, so threads reading the same tree don't race on it)
 
         //default just throws the string, can be set if you want to avoid exceptions
         static std::function<void(const std::string&)> ErrorCallback;
@@ -39,28 +179,53 @@ class GonObject {
             MULTIPLY
         };
 
-        std::unordered_map<std::string, int> children_map;
-        std::vector<GonObject> children_array;
-        int int_data;
+        //all storage of a tree comes from one std::pmr::memory_resource (the default resource unless one is given to Load/LoadFromBuffer or the constructor)
+        //children inherit their parent's resource, copy-constructing an object puts the copy back on the default resource
+        typedef std::pmr::polymorphic_allocator<char> allocator_type;
+
+        std::pmr::unordered_map<std::pmr::string, int> children_map;
+        std::pmr::vector<GonObject> children_array;
+        int64_t int_data;
         double float_data;
         bool bool_data;
-        std::string string_data;
-        std::string name;
+        std::pmr::string string_data;
+        std::pmr::string name;
         FieldType type;
+        GonIndexHandle indexes;
 
         static MergeMode MergePolicyAppend(const GonObject& field_a, const GonObject& field_b);
         static MergeMode MergePolicyMerge(const GonObject& field_a, const GonObject& field_b);
         static MergeMode MergePolicyOverwrite(const GonObject& field_a, const GonObject& field_b);
         static GonObject Load(const std::string& filename);
         static GonObject LoadFromBuffer(const std::string& buffer);
+
+        //same as above, but every string, map node and array of the resulting tree is allocated from resource
+        //with a std::pmr::monotonic_buffer_resource deallocation is a no-op, so a load-once tree can be dropped in bulk by releasing the arena
+        //(the arena must outlive the tree, and moving the tree into an object that uses a different resource deep-copies it)
+        static GonObject Load(const std::string& filename, std::pmr::memory_resource* resource);
+        static GonObject LoadFromBuffer(const std::string& buffer, std::pmr::memory_resource* resource);
+
+        //json documents are read with a dedicated strict json parser, their root object or array becomes the returned object
+        static GonObject Load(const std::string& filename, const GonLoadOptions& options);
+        static GonObject LoadFromBuffer(const std::string& buffer, const GonLoadOptions& options);
         typedef std::function<MergeMode(const GonObject& field_a, const GonObject& field_b)> MergePolicyCallback;
 
         GonObject();
+        explicit GonObject(const allocator_type& alloc);
+        GonObject(const GonObject& other, const allocator_type& alloc);
+        GonObject(GonObject&& other, const allocator_type& alloc);
+        GonObject(const GonObject& other) = default;
+        GonObject(GonObject&& other) = default;
+        GonObject& operator=(const GonObject& other) = default;
+        GonObject& operator=(GonObject&& other) = default;
+
+        allocator_type get_allocator() const;
 
         //throw error if accessing wrong type, otherwise return correct type
         std::string String() const;
         const char* CString() const;
         int Int() const;
+        int64_t Int64() const;
         double Number() const;
         double Percent() const;
         bool Bool() const;
@@ -69,31 +234,32 @@ class GonObject {
         std::string String(const std::string& _default) const;
         const char* CString(const char* _default) const;
         int Int(int _default) const;
+        int64_t Int64(int64_t _default) const;
         double Number(double _default) const;
         double Percent(double _default) const; //if field is a number-parsable string that ends with a %, return that number divided by 100, otherwise just return the number
         bool Bool(bool _default) const;
 
-        bool Contains(const std::string& child) const;
-        bool ContainsNthChildWithName(const std::string& child, int index) const; //similar to just operator[], however if index is more than 0 then it skips the first N children with that name (ex, index=1 searches for the *second* field named "child" in the object)
+        bool Contains(std::string_view child) const;
+        bool ContainsNthChildWithName(std::string_view child, int index) const; //similar to just operator[], however if index is more than 0 then it skips the first N children with that name (ex, index=1 searches for the *second* field named "child" in the object)
         bool Contains(int child) const;
         bool Exists() const; //true if non-null
         bool IsPercent() const; //while regular numbers can be read as percents, "is percent" only returns true if the string ends with a %
 
         //returns null_gon if the field does not exist.
-        const GonObject& operator[](const std::string& child) const;
-        GonObject& operator[](const std::string& child);
+        const GonObject& operator[](std::string_view child) const;
+        GonObject& operator[](std::string_view child);
 
         //returns self if child does not exist (useful for stuff that can either be a child or the default property of a thing)
-        const GonObject& ChildOrSelf(const std::string& child) const;
-        GonObject& ChildOrSelf(const std::string& child);
+        const GonObject& ChildOrSelf(std::string_view child) const;
+        GonObject& ChildOrSelf(std::string_view child);
 
         //similar to just operator[], however if index is more than 0 then it skips the first N children with that name (ex, index=1 searches for the *second* field named "child" in the object)
-        const GonObject& NthChildWithName(const std::string& child, int index) const;
-        GonObject& NthChildWithName(const std::string& child, int index);
+        const GonObject& NthChildWithName(std::string_view child, int index) const;
+        GonObject& NthChildWithName(std::string_view child, int index);
 
         //checks for [child][field], if that doesnt exists returns [field] instead. look I was using this pattern a ton with things that could have optional variants
-        const GonObject& FieldInChildOrSelf(const std::string& child, const std::string& field) const;
-        GonObject& FieldInChildOrSelf(const std::string& child, const std::string& field);
+        const GonObject& FieldInChildOrSelf(std::string_view child, std::string_view field) const;
+        GonObject& FieldInChildOrSelf(std::string_view child, std::string_view field);
 
         //returns self if index is not an array,
         //all objects can be considered an array of size 1 with themselves as the member, if they are not an ARRAY or an OBJECT
@@ -117,11 +283,38 @@ class GonObject {
         std::string SaveToStr(bool compact = false) const;
         std::string GetOutStr(const std::string& tab = "    ", const std::string& line_break = "\n", const std::string& current_tab = "") const;
 
+        //memory used by this node and everything under it
+        GonMemoryUsage MemoryUsage() const;
+
+        //shrinks every vector and string in the subtree to fit and rebuilds each children_map at the right size (empty for non-objects)
+        //worth doing after a load or merges for trees that are kept around, it doesn't change any values or child order
+        //(with a monotonic arena the old buffers aren't given back until the arena is released)
+        void Compact();
+
+        //secondary indexes over the children of an object or array, keyed by the value of a field in each child:
+        //    units.BuildIndex("type");
+        //    for(int i : units.FindAll("type", "enemy")) Spawn(units[i]);
+        //path is a field name, names separated by dots for nested fields ("stats.element"), or empty to index children by their own value
+        //values are compared as text (so 5 and 5.0 are different keys), children where path isn't a string, number or bool are left out
+        //InsertChild and Append add new children to the indexes, the merge functions rebuild them once they're done
+        //changes made any other way (through children_array or the non-const accessors) aren't seen until BuildIndex is called again
+        void BuildIndex(std::string_view path); //builds or rebuilds
+        void DropIndex(std::string_view path);
+        bool HasIndex(std::string_view path) const;
+
+        //positions in children_array of the children whose value at path is value, in order
+        //asking for a path without an index is an error
+        const std::vector<int>& FindAll(std::string_view path, std::string_view value) const;
+
+        //first child whose value at path is value, null_gon if there is none
+        const GonObject& FindFirst(std::string_view path, std::string_view value) const;
+        GonObject& FindFirst(std::string_view path, std::string_view value);
+
         //if nullgon -> promotes to object
         //if object or array -> adds as child
         //otherwise, error
         void InsertChild(const GonObject& other);
-        void InsertChild(std::string cname, const GonObject& other);
+        void InsertChild(std::string_view cname, const GonObject& other);
 
         //merging/combining functions
         //if self and other are an OBJECT: other will be appended to self
@@ -158,3 +351,72 @@ class GonObject {
         //.add is treated as .append for non-numerical types, .multiply is treated as .merge for non-numerical types
         void PatchMerge(const GonObject& patch);
 };
+
+//incremental loading, for documents that arrive in pieces (file chunks, network packets)
+//only the tokens are kept between chunks, the tree is built in Finish, the result is the same as LoadFromBuffer on the whole text
+//(json documents are buffered whole and parsed in Finish, the syntax is detected from the first bytes like LoadFromBuffer does)
+class GonStreamParser {
+    public:
+        GonStreamParser(const GonLoadOptions& options = GonLoadOptions());
+        ~GonStreamParser();
+
+        void Feed(std::string_view chunk);
+        GonObject Finish();
+
+        uint64_t BytesFed() const;
+
+    private:
+        struct State;
+        std::unique_ptr<State> state;
+};
+
+//what a GonAccessProfiler run did to one tree, paths are field names separated by dots with [] for array entries ("units[].hp"),
+//so the counts for every entry of an array (or for each same-named field) add up into one line
+struct GonAccessReport {
+    struct Path {
+        std::string path;
+        uint64_t lookups = 0; //by-name lookups that found a node at this path
+        uint64_t reads = 0;   //typed accessor calls (String, Int, Number, Bool...) on a node at this path
+        uint64_t nodes = 0;   //nodes at this path that were looked up or read
+    };
+    struct Miss {
+        std::string path;     //the parent's path and the key that wasn't found
+        uint64_t count = 0;
+    };
+    struct Unused {
+        std::string path;
+        uint64_t subtrees = 0; //nodes at this path with nothing under them accessed (while their parent had something accessed)
+        uint64_t nodes = 0;    //nodes in those subtrees
+    };
+
+    std::vector<Path> hottest;   //by lookups + reads, most first
+    std::vector<Miss> misses;    //lookups that returned null_gon (or self, for ChildOrSelf), most first
+    std::vector<Unused> unused;  //never-accessed subtrees, biggest first
+
+    uint64_t nodes = 0;          //nodes in the tree
+    uint64_t accessed_nodes = 0; //nodes that were looked up or read
+
+    std::string ToString(size_t lines = 20) const; //at most lines entries per section
+};
+
+//counts by-name lookups (operator[], NthChildWithName, ChildOrSelf, FieldInChildOrSelf) and typed accessor reads per node while running,
+//to find data that's never read and fields worth caching instead of looking them up every frame:
+//
+//    GonAccessProfiler::Start();
+//    RunGame();
+//    GonAccessProfiler::Stop();
+//    printf("%s", GonAccessProfiler::Report(config).ToString().c_str());
+//
+//only compiled in when gon.cpp is built with GON_ACCESS_PROFILER, otherwise Start does nothing and reports are empty
+//every thread counts into its own table, nodes are identified by address, so the profiled tree must not be modified or destroyed between Start and Report
+//(call Reset before profiling a different tree), going through children_array or iterating with begin/end isn't counted
+class GonAccessProfiler {
+    public:
+        static void Start();
+        static void Stop();
+        static bool Running();
+        static void Reset(); //forgets all counts, on every thread
+
+        //counts from every thread for the nodes of root's tree, counts for other trees are left out
+        static GonAccessReport Report(const GonObject& root);
+};
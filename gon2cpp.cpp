@@ -0,0 +1,297 @@
+//Glaiel Object Notation
+//gon2cpp: converts .gon files into static C++ tables read through GonStaticView (gon_static.h), so shipping builds don't parse them at startup
+//
+//build (the tool itself needs C++20 for gon_constexpr.h, the generated code only needs C++17):
+//    g++ -O2 -std=c++20 gon2cpp.cpp gon.cpp -o gon2cpp
+//usage:
+//    gon2cpp [--structs] -o out/balance balance.gon [enemies.gon ...]
+//writes out/balance.h and out/balance.cpp, with one `extern const GonStaticView <file stem>` per input
+//
+//--structs also emits a plain struct array for every object or array whose entries all have the same scalar fields, ex:
+//    enemies { goblin { hp 10 speed 2.5 } orc { hp 30 speed 1 } }
+//becomes
+//    struct balance_enemies_row { const char* gon_name; int64_t hp; double speed; };
+//    extern const balance_enemies_row balance_enemies[2];
+
+#include "gon_constexpr.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+static std::string Identifier(const std::string& str){
+    std::string res;
+    for(char c : str){
+        bool alnum = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        res += alnum ? c : '_';
+    }
+    if(res.empty() || (res[0] >= '0' && res[0] <= '9')) res = "_"+res;
+    return res;
+}
+
+static bool IsIdentifier(std::string_view str){
+    static const char* keywords[] = {
+        "alignas", "alignof", "and", "asm", "auto", "bool", "break", "case", "catch", "char", "class", "const", "constexpr",
+        "continue", "default", "delete", "do", "double", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+        "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "nullptr", "operator",
+        "or", "private", "protected", "public", "register", "return", "short", "signed", "sizeof", "static", "struct", "switch",
+        "template", "this", "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual",
+        "void", "volatile", "while", "xor", "gon_name"
+    };
+    if(str.empty() || (str[0] >= '0' && str[0] <= '9')) return false;
+    for(char c : str){
+        if(!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')) return false;
+    }
+    for(const char* keyword : keywords){
+        if(str == keyword) return false;
+    }
+    return true;
+}
+
+static std::string FileStem(const std::string& path){
+    size_t slash = path.find_last_of("/\\");
+    std::string file = slash == std::string::npos ? path : path.substr(slash+1);
+    size_t dot = file.find_last_of('.');
+    return dot == std::string::npos ? file : file.substr(0, dot);
+}
+
+static const char* TypeName(GonObject::FieldType type){
+    switch(type){
+        case GonObject::FieldType::NULLGON: return "FieldType::NULLGON";
+        case GonObject::FieldType::STRING:  return "FieldType::STRING";
+        case GonObject::FieldType::NUMBER:  return "FieldType::NUMBER";
+        case GonObject::FieldType::OBJECT:  return "FieldType::OBJECT";
+        case GonObject::FieldType::ARRAY:   return "FieldType::ARRAY";
+        case GonObject::FieldType::BOOL:    return "FieldType::BOOL";
+    }
+    return "FieldType::NULLGON";
+}
+
+static std::string Int64Literal(int64_t value){
+    if(value == INT64_MIN) return "INT64_MIN";
+    return std::to_string(value);
+}
+
+static std::string DoubleLiteral(double value){
+    if(value != value) return "std::numeric_limits<double>::quiet_NaN()";
+    if(value == std::numeric_limits<double>::infinity()) return "std::numeric_limits<double>::infinity()";
+    if(value == -std::numeric_limits<double>::infinity()) return "-std::numeric_limits<double>::infinity()";
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.17g", value);
+
+    //always a floating point literal, "-0" would be the integer 0 and lose the sign
+    std::string res = buf;
+    if(res.find_first_of(".e") == std::string::npos) res += ".0";
+    return res;
+}
+
+//octal escapes are always 3 digits, so a following digit can't extend them
+static void WriteEscaped(std::ostream& out, std::string_view str){
+    for(unsigned char c : str){
+        if(c == '"' || c == '\\') out << '\\' << c;
+        else if(c == '\n') out << "\\n";
+        else if(c < 32 || c >= 127){
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\%03o", c);
+            out << buf;
+        }
+        else out << c;
+    }
+}
+
+//a group of entries that all have the same scalar fields
+struct GonRowShape {
+    std::vector<std::string> fields;
+    std::vector<std::string> types;
+};
+
+static bool InferRowShape(const GonStaticView& container, GonRowShape& shape){
+    if(container.Type() != GonObject::FieldType::OBJECT && container.Type() != GonObject::FieldType::ARRAY) return false;
+    if(container.size() < 2) return false;
+
+    bool first = true;
+    for(GonStaticView row : container){
+        if(row.Type() != GonObject::FieldType::OBJECT) return false;
+
+        std::vector<std::string> fields;
+        for(GonStaticView field : row){
+            if(!IsIdentifier(field.Name())) return false;
+            if(field.Type() != GonObject::FieldType::NUMBER && field.Type() != GonObject::FieldType::STRING && field.Type() != GonObject::FieldType::BOOL) return false;
+            fields.push_back(std::string(field.Name()));
+        }
+        std::vector<std::string> sorted = fields;
+        std::sort(sorted.begin(), sorted.end());
+        if(std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) return false;
+
+        if(first){
+            shape.fields = fields;
+            shape.types.assign(fields.size(), "");
+            first = false;
+        } else {
+            std::vector<std::string> expected = shape.fields;
+            std::sort(expected.begin(), expected.end());
+            if(expected != sorted) return false;
+        }
+
+        for(size_t i = 0; i<shape.fields.size(); i++){
+            GonStaticView field = row[shape.fields[i]];
+            std::string type;
+            if(field.Type() == GonObject::FieldType::STRING) type = "const char*";
+            if(field.Type() == GonObject::FieldType::BOOL) type = "bool";
+            if(field.Type() == GonObject::FieldType::NUMBER) type = ((double)field.Int64() == field.Number()) ? "int64_t" : "double";
+
+            std::string& current = shape.types[i];
+            if(current.empty() || current == type) current = type;
+            else if((current == "int64_t" && type == "double") || (current == "double" && type == "int64_t")) current = "double";
+            else return false;
+        }
+    }
+    return true;
+}
+
+struct GonCppWriter {
+    std::ostringstream header;
+    std::ostringstream source;
+
+    void WriteRows(const std::string& symbol, const std::string& prefix, const GonStaticView& container, const GonRowShape& shape){
+        std::string row_type = prefix+"_row";
+        header << "\nstruct " << row_type << " {\n    const char* gon_name;\n";
+        for(size_t i = 0; i<shape.fields.size(); i++) header << "    " << shape.types[i] << " " << shape.fields[i] << ";\n";
+        header << "};\n";
+        header << "extern const " << row_type << " " << prefix << "[" << container.size() << "];\n";
+
+        //strings point into the node table's pool
+        source << "\nconst " << row_type << " " << prefix << "[" << container.size() << "] = {\n";
+        for(GonStaticView row : container){
+            source << "    {" << PoolPointer(symbol, row.Name());
+            for(size_t i = 0; i<shape.fields.size(); i++){
+                GonStaticView field = row[shape.fields[i]];
+                source << ", ";
+                if(shape.types[i] == "const char*") source << PoolPointer(symbol, field.StringView());
+                else if(shape.types[i] == "bool") source << (field.Bool() ? "true" : "false");
+                else if(shape.types[i] == "int64_t") source << Int64Literal(field.Int64());
+                else source << DoubleLiteral(field.Number());
+            }
+            source << "},\n";
+        }
+        source << "};\n";
+    }
+
+    //finds rows to turn into structs, following identifier-named fields from the root
+    void WriteStructs(const std::string& symbol, const std::string& prefix, const GonStaticView& node){
+        GonRowShape shape;
+        if(node.Name().size() && InferRowShape(node, shape)){
+            WriteRows(symbol, prefix, node, shape);
+            return;
+        }
+        if(node.Type() != GonObject::FieldType::OBJECT) return;
+        std::map<std::string_view, int> counts;
+        for(GonStaticView child : node) counts[child.Name()]++;
+        for(GonStaticView child : node){
+            if(!IsIdentifier(child.Name()) || counts[child.Name()] > 1) continue;
+            WriteStructs(symbol, prefix+"_"+std::string(child.Name()), child);
+        }
+    }
+
+    std::string PoolPointer(const std::string& symbol, std::string_view str){
+        return symbol+"_pool + "+std::to_string(pool_offsets.at(std::string(str)));
+    }
+
+    std::map<std::string, uint32_t> pool_offsets;
+
+    void WriteTables(const std::string& symbol, const GonStaticParser& tables){
+        header << "\nextern const GonStaticView " << symbol << ";\n";
+
+        source << "\nstatic const char " << symbol << "_pool[] =\n";
+        pool_offsets.clear();
+        size_t start = 0;
+        while(start < tables.pool.size()){
+            size_t end = tables.pool.find('\0', start);
+            std::string_view str(tables.pool.data()+start, end-start);
+            pool_offsets[std::string(str)] = (uint32_t)start;
+            source << "    \"";
+            WriteEscaped(source, str);
+            source << (end+1 < tables.pool.size() ? "\\0\"\n" : "\"\n");
+            start = end+1;
+        }
+        if(tables.pool.empty()) source << "    \"\"\n";
+        source << ";\n";
+
+        source << "\nstatic const GonStaticNode " << symbol << "_nodes[] = {\n";
+        for(const GonStaticNode& node : tables.nodes){
+            source << "    {" << TypeName(node.type) << ", " << (node.bool_data ? "true" : "false") << ", "
+                   << node.name << ", " << node.name_length << ", " << node.string_data << ", " << node.string_length << ", "
+                   << node.first_child << ", " << node.child_count << ", " << node.keys << ", " << node.key_count << ", "
+                   << Int64Literal(node.int_data) << ", " << DoubleLiteral(node.float_data) << "},\n";
+        }
+        source << "};\n";
+
+        source << "\nstatic const uint32_t " << symbol << "_keys[] = {";
+        for(size_t i = 0; i<tables.keys.size(); i++) source << (i%16 == 0 ? "\n    " : " ") << tables.keys[i] << ",";
+        if(tables.keys.empty()) source << "0";
+        source << "\n};\n";
+
+        source << "\nconst GonStaticView " << symbol << "(" << symbol << "_nodes, " << symbol << "_pool, " << symbol << "_keys, 0);\n";
+    }
+};
+
+static bool WriteFile(const std::string& path, const std::string& contents){
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+    return (bool)out;
+}
+
+int main(int argc, char** argv){
+    bool structs = false;
+    std::string output;
+    std::vector<std::string> inputs;
+    for(int i = 1; i<argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--structs") structs = true;
+        else if(arg == "-o" && i+1 < argc) output = argv[++i];
+        else inputs.push_back(arg);
+    }
+    if(output.empty() || inputs.empty()){
+        std::cerr << "usage: gon2cpp [--structs] -o output_basename input.gon [input2.gon ...]\n";
+        return 1;
+    }
+
+    GonCppWriter writer;
+    std::string sources;
+    for(const std::string& input : inputs) sources += (sources.empty() ? "" : ", ")+input;
+    writer.header << "//generated by gon2cpp from " << sources << ", do not edit\n\n#pragma once\n#include \"gon_static.h\"\n";
+    writer.source << "//generated by gon2cpp from " << sources << ", do not edit\n\n#include \"" << FileStem(output) << ".h\"\n#include <limits>\n\nusing FieldType = GonObject::FieldType;\n";
+
+    for(const std::string& input : inputs){
+        if(!std::ifstream(input)){
+            std::cerr << "gon2cpp: can't open " << input << "\n";
+            return 1;
+        }
+
+        GonStaticParser tables;
+        try {
+            GonObject obj = GonObject::Load(input);
+            tables.LoadFrom(obj);
+        } catch(const std::string& error){
+            std::cerr << input << ": " << error << "\n";
+            return 1;
+        }
+        tables.Layout();
+
+        std::string symbol = Identifier(FileStem(input));
+        writer.WriteTables(symbol, tables);
+        if(structs){
+            GonStaticView root(tables.nodes.data(), tables.pool.data(), tables.keys.data(), 0);
+            writer.WriteStructs(symbol, symbol, root);
+        }
+    }
+
+    if(!WriteFile(output+".h", writer.header.str()) || !WriteFile(output+".cpp", writer.source.str())){
+        std::cerr << "gon2cpp: can't write " << output << ".h/.cpp\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,314 @@
+#include "gon_async.h"
+
+#include <fstream>
+
+GonThreadPool::GonThreadPool(int threads):stopping(false){
+    for(int i = 0; i<threads; i++){
+        workers.emplace_back([this]{ Run(); });
+    }
+}
+GonThreadPool::~GonThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(std::thread& worker : workers) worker.join();
+}
+
+void GonThreadPool::Post(std::function<void()> job){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    wake.notify_one();
+}
+
+void GonThreadPool::Run(){
+    while(true){
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]{ return stopping || !jobs.empty(); });
+            if(jobs.empty()) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+GonThreadPool& GonThreadPool::Default(){
+    static GonThreadPool pool;
+    return pool;
+}
+
+//same as GonObject::Load, includes are relative to the file being loaded
+static GonLoadOptions FileLoadOptions(const std::string& filename, const GonLoadOptions& options){
+    GonLoadOptions res = options;
+    if(res.includes && res.source.empty()) res.source = filename;
+    return res;
+}
+
+//a load is a chain of jobs: step k tokenizes chunk k while a separate job reads chunk k+1 into the other buffer,
+//whichever of the two finishes last posts step k+1, so no job ever waits on another
+struct GonLoadHandle::State {
+    std::string filename;
+    GonAsyncOptions options;
+    GonExecutor* executor;
+
+    std::ifstream in;
+    GonStreamParser parser;
+    std::vector<char> buffers[2];
+    size_t sizes[2];
+    std::atomic<int> arrivals;
+
+    std::atomic<bool> cancelled;
+    std::atomic<uint64_t> bytes_parsed;
+    std::atomic<uint64_t> total_bytes;
+    uint64_t bytes_read;
+
+    std::mutex mutex;
+    std::condition_variable done_signal;
+    bool done;
+    GonObject result;
+    std::string error;
+    std::exception_ptr exception;
+    std::vector<std::function<void()>> callbacks;
+
+    State(const std::string& filename, const GonAsyncOptions& options)
+        :filename(filename),options(options),executor(options.executor?options.executor:&GonThreadPool::Default()),
+         parser(FileLoadOptions(filename, options.load)),sizes{0, 0},arrivals(0),cancelled(false),bytes_parsed(0),total_bytes(0),bytes_read(0),done(false){
+    }
+};
+
+static void CompleteLoad(const std::shared_ptr<GonLoadHandle::State>& state){
+    state->in.close();
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->done = true;
+        callbacks.swap(state->callbacks);
+    }
+    state->done_signal.notify_all();
+    for(std::function<void()>& callback : callbacks) state->executor->Post(std::move(callback));
+}
+
+//buffers are only as big as what's left of the file, small files don't pay for a full chunk
+static size_t ReadChunk(GonLoadHandle::State& state, int slot){
+    uint64_t remaining = state.total_bytes - state.bytes_read;
+    if(remaining == 0) return 0;
+    std::vector<char>& buffer = state.buffers[slot];
+    buffer.resize((size_t)std::min<uint64_t>(std::max<size_t>(state.options.chunk_size, 1), remaining));
+    state.in.read(buffer.data(), buffer.size());
+    size_t read = (size_t)state.in.gcount();
+    state.bytes_read += read;
+    return read;
+}
+
+static void LoadStep(const std::shared_ptr<GonLoadHandle::State>& state, uint64_t chunk);
+
+static void ArriveAtStep(const std::shared_ptr<GonLoadHandle::State>& state, uint64_t chunk){
+    if(state->arrivals.fetch_sub(1, std::memory_order_acq_rel) == 1){
+        state->executor->Post([state, chunk]{ LoadStep(state, chunk); });
+    }
+}
+
+static void LoadStep(const std::shared_ptr<GonLoadHandle::State>& state, uint64_t chunk){
+    if(state->cancelled){
+        state->error = "GON ERROR: Loading \""+state->filename+"\" was cancelled";
+        CompleteLoad(state);
+        return;
+    }
+
+    int slot = (int)(chunk%2);
+    if(state->sizes[slot] == 0){
+        try {
+            state->result = state->parser.Finish();
+        } catch(const std::string& error) {
+            state->error = error; //reported again from Get, on the caller's thread
+        } catch(...) {
+            state->exception = std::current_exception();
+        }
+        CompleteLoad(state);
+        return;
+    }
+
+    state->arrivals = 2;
+    state->executor->Post([state, chunk]{
+        int next = (int)((chunk+1)%2);
+        state->sizes[next] = ReadChunk(*state, next);
+        ArriveAtStep(state, chunk+1);
+    });
+
+    state->parser.Feed(std::string_view(state->buffers[slot].data(), state->sizes[slot]));
+    state->bytes_parsed += state->sizes[slot];
+    ArriveAtStep(state, chunk+1);
+}
+
+static void StartLoad(const std::shared_ptr<GonLoadHandle::State>& state){
+    state->executor->Post([state]{
+        if(!state->cancelled){
+            state->in.open(state->filename.c_str(), std::ios::binary);
+            if(!state->in){
+                state->error = "GON ERROR: Unable to open \""+state->filename+"\"";
+                CompleteLoad(state);
+                return;
+            }
+            state->in.seekg(0, std::ios::end);
+            state->total_bytes = (uint64_t)state->in.tellg();
+            state->in.seekg(0, std::ios::beg);
+            state->sizes[0] = ReadChunk(*state, 0);
+        }
+        LoadStep(state, 0);
+    });
+}
+
+GonLoadHandle::GonLoadHandle(){
+}
+GonLoadHandle::GonLoadHandle(std::shared_ptr<State> state):state(std::move(state)){
+}
+
+bool GonLoadHandle::Valid() const {
+    return state != nullptr;
+}
+bool GonLoadHandle::Ready() const {
+    if(!state) return true;
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->done;
+}
+void GonLoadHandle::Wait() const {
+    if(!state) return;
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done_signal.wait(lock, [this]{ return state->done; });
+}
+
+const GonObject& GonLoadHandle::Get() const {
+    if(!state) return GonObject::null_gon;
+    Wait();
+    if(state->exception) std::rethrow_exception(state->exception);
+    if(!state->error.empty()){
+        GonObject::ErrorCallback(state->error);
+        return GonObject::null_gon;
+    }
+    return state->result;
+}
+GonObject GonLoadHandle::Take(){
+    if(!state) return GonObject::null_gon;
+    Get();
+    if(state->exception || !state->error.empty()) return GonObject::null_gon;
+    return std::move(state->result);
+}
+
+void GonLoadHandle::Cancel(){
+    if(state) state->cancelled = true;
+}
+bool GonLoadHandle::Cancelled() const {
+    return state && state->cancelled;
+}
+
+uint64_t GonLoadHandle::BytesParsed() const {
+    return state ? state->bytes_parsed.load() : 0;
+}
+uint64_t GonLoadHandle::TotalBytes() const {
+    return state ? state->total_bytes.load() : 0;
+}
+const std::string& GonLoadHandle::Filename() const {
+    static const std::string none;
+    return state ? state->filename : none;
+}
+
+void GonLoadHandle::OnReady(std::function<void()> callback) const {
+    if(!state) return;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if(!state->done){
+            state->callbacks.push_back(std::move(callback));
+            return;
+        }
+    }
+    state->executor->Post(std::move(callback));
+}
+
+GonLoadHandle GonLoadAsync(const std::string& filename, const GonAsyncOptions& options){
+    std::shared_ptr<GonLoadHandle::State> state = std::make_shared<GonLoadHandle::State>(filename, options);
+    StartLoad(state);
+    return GonLoadHandle(state);
+}
+
+//loads past max_open wait here, each finished load starts the next one
+struct GonLoadBatch::Queue {
+    std::mutex mutex;
+    std::deque<std::shared_ptr<GonLoadHandle::State>> waiting;
+    int open;
+    int max_open;
+};
+
+GonLoadBatch::GonLoadBatch(const GonAsyncOptions& options, int max_open):options(options),queue(std::make_shared<Queue>()){
+    queue->open = 0;
+    queue->max_open = std::max(1, max_open);
+}
+
+GonLoadHandle GonLoadBatch::Add(const std::string& filename){
+    std::shared_ptr<GonLoadHandle::State> state = std::make_shared<GonLoadHandle::State>(filename, options);
+    std::shared_ptr<Queue> queue = this->queue;
+    state->callbacks.push_back([queue]{
+        std::shared_ptr<GonLoadHandle::State> next;
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if(queue->waiting.empty()){
+                queue->open--;
+                return;
+            }
+            next = queue->waiting.front();
+            queue->waiting.pop_front();
+        }
+        StartLoad(next);
+    });
+
+    bool start = false;
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if(queue->open < queue->max_open){
+            queue->open++;
+            start = true;
+        } else {
+            queue->waiting.push_back(state);
+        }
+    }
+    if(start) StartLoad(state);
+
+    handles.push_back(GonLoadHandle(state));
+    return handles.back();
+}
+
+int GonLoadBatch::Size() const {
+    return (int)handles.size();
+}
+const GonLoadHandle& GonLoadBatch::operator[](int index) const {
+    return handles[index];
+}
+
+bool GonLoadBatch::Ready() const {
+    for(const GonLoadHandle& handle : handles){
+        if(!handle.Ready()) return false;
+    }
+    return true;
+}
+void GonLoadBatch::Wait() const {
+    for(const GonLoadHandle& handle : handles) handle.Wait();
+}
+void GonLoadBatch::Cancel(){
+    for(GonLoadHandle& handle : handles) handle.Cancel();
+}
+
+uint64_t GonLoadBatch::BytesParsed() const {
+    uint64_t total = 0;
+    for(const GonLoadHandle& handle : handles) total += handle.BytesParsed();
+    return total;
+}
+uint64_t GonLoadBatch::TotalBytes() const {
+    uint64_t total = 0;
+    for(const GonLoadHandle& handle : handles) total += handle.TotalBytes();
+    return total;
+}
@@ -0,0 +1,126 @@
+//Glaiel Object Notation
+//background loading: futures, coroutines and batches
+
+#pragma once
+#include "gon.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define GON_ASYNC_COROUTINES 1
+#endif
+
+//anything that can run jobs, load jobs never block waiting on each other so even a single thread can run any number of loads
+class GonExecutor {
+    public:
+        virtual ~GonExecutor(){}
+        virtual void Post(std::function<void()> job) = 0;
+};
+
+class GonThreadPool : public GonExecutor {
+    public:
+        GonThreadPool(int threads = std::max(1, (int)std::thread::hardware_concurrency()));
+        ~GonThreadPool(); //runs the jobs that are still queued, then joins
+
+        void Post(std::function<void()> job) override;
+
+        //shared pool used when GonAsyncOptions::executor is null
+        static GonThreadPool& Default();
+
+    private:
+        void Run();
+
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> jobs;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping;
+};
+
+struct GonAsyncOptions {
+    GonLoadOptions load;              //the tree is built on an executor thread, so options.load.resource must not be used by anything else during the load
+    GonExecutor* executor = nullptr;  //GonThreadPool::Default() if null
+    size_t chunk_size = 1<<20;        //the next chunk is read while the previous one is tokenized
+};
+
+//a load in progress, copies refer to the same load
+class GonLoadHandle {
+    public:
+        GonLoadHandle();
+
+        bool Valid() const;
+        bool Ready() const;
+        void Wait() const;
+
+        //waits, then returns the tree (null_gon if the load failed or was cancelled)
+        //errors (missing file, cancelled, or what GonObject::ErrorCallback threw while parsing) are reported through ErrorCallback on the calling thread,
+        //so with the default callback they throw here like Load would
+        const GonObject& Get() const;
+        GonObject Take(); //same as Get, but moves the tree out of the shared state
+
+        //cancellation is checked between chunks, a cancelled load reports an error from Get
+        void Cancel();
+        bool Cancelled() const;
+
+        uint64_t BytesParsed() const;
+        uint64_t TotalBytes() const; //0 until the file is opened
+        const std::string& Filename() const;
+
+        //callback runs on the executor once the load is done (right away if it already is)
+        void OnReady(std::function<void()> callback) const;
+
+        struct State; //defined in gon_async.cpp
+
+    private:
+        explicit GonLoadHandle(std::shared_ptr<State> state);
+        std::shared_ptr<State> state;
+
+        friend GonLoadHandle GonLoadAsync(const std::string& filename, const GonAsyncOptions& options);
+        friend class GonLoadBatch;
+};
+
+#ifdef GON_ASYNC_COROUTINES
+//co_await on a handle resumes on the executor and takes the result (like Take)
+struct GonLoadAwaiter {
+    GonLoadHandle handle;
+    bool await_ready() const { return handle.Ready(); }
+    void await_suspend(std::coroutine_handle<> coroutine) const { handle.OnReady([coroutine]{ coroutine.resume(); }); }
+    GonObject await_resume() { return handle.Take(); }
+};
+inline GonLoadAwaiter operator co_await(const GonLoadHandle& handle){
+    return GonLoadAwaiter{handle};
+}
+#endif
+
+//starts loading filename in the background (the async version of GonObject::Load)
+GonLoadHandle GonLoadAsync(const std::string& filename, const GonAsyncOptions& options = GonAsyncOptions());
+
+//many loads sharing one executor, at most max_open files are open at once and the rest wait in a queue
+class GonLoadBatch {
+    public:
+        GonLoadBatch(const GonAsyncOptions& options = GonAsyncOptions(), int max_open = 64);
+
+        GonLoadHandle Add(const std::string& filename);
+
+        int Size() const;
+        const GonLoadHandle& operator[](int index) const;
+
+        bool Ready() const;
+        void Wait() const;
+        void Cancel();
+
+        uint64_t BytesParsed() const;
+        uint64_t TotalBytes() const; //only counts files that have been opened so far
+
+    private:
+        struct Queue;
+        GonAsyncOptions options;
+        std::vector<GonLoadHandle> handles;
+        std::shared_ptr<Queue> queue;
+};
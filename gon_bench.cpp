@@ -0,0 +1,532 @@
+//Glaiel Object Notation
+//gon_bench: parse, lookup, save and merge timings on generated documents, for tracking performance across versions
+//
+//build:
+//    g++ -O2 -std=c++17 gon_bench.cpp gon.cpp gon_path.cpp gon_overlay.cpp -o gon_bench
+//usage:
+//    gon_bench [--sizes 64KB,4MB] [--corpora wide,deep,...] [--repeat 5] [--json] [--write-corpus dir]
+//
+//every corpus is generated from a fixed seed, so a given kind and size is the same document on every machine and version:
+//    wide        a few huge objects with many distinct keys
+//    deep        chains of nested objects and arrays, up to 48 levels
+//    strings     long quoted strings with spaces and escapes
+//    numbers     arrays of ints, floats, hex and exponents
+//    dupkeys     objects that repeat the same few keys many times
+//    json        strict json records (read by the json parser)
+//    comments    records with a comment on every other line
+//
+//per corpus and size it reports:
+//    parse       LoadFromBuffer, MB/s of input, allocations and bytes allocated by one parse
+//    lookup      operator[] on keys that exist, ns per lookup
+//    chain       chained operator[] on paths 1-4 fields deep that exist, ns per path
+//    path        the same paths as precompiled GonPaths, ns per path
+//    pathbatch   the same paths in one GonPathBatch, ns per path
+//    save        GetOutStr, MB/s of output
+//    deepmerge   DeepMerge of a patch touching every 4th top level field, MB/s of the patch's text
+//    patchmerge  PatchMerge with the same patch
+//    overlay     the chain paths read through a GonOverlay of the tree and the patch, ns per path
+//    flatten     Flatten of that overlay, which copies the whole merged tree, MB/s of the document's text
+//timings are the best of --repeat runs (median in the json output too), peak_rss is the whole process so far
+//--json prints one json object per line instead of a table, to diff between versions or feed dashboards
+//(a 1GB corpus needs roughly 20-30GB of memory for the loaded tree)
+
+#include "gon.h"
+#include "gon_overlay.h"
+#include "gon_path.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+//allocation counters, every operator new in the process goes through these
+static size_t allocation_count = 0;
+static size_t allocation_bytes = 0;
+
+static void* CountedAlloc(size_t size){
+    allocation_count++;
+    allocation_bytes += size;
+    if(void* res = std::malloc(size ? size : 1)) return res;
+    throw std::bad_alloc();
+}
+static void* CountedAlignedAlloc(size_t size, size_t alignment){
+    allocation_count++;
+    allocation_bytes += size;
+    size = (size + alignment - 1) / alignment * alignment;
+    #ifdef _WIN32
+    if(void* res = _aligned_malloc(size ? size : alignment, alignment)) return res;
+    #else
+    if(void* res = std::aligned_alloc(alignment, size ? size : alignment)) return res;
+    #endif
+    throw std::bad_alloc();
+}
+static void CountedAlignedFree(void* ptr){
+    #ifdef _WIN32
+    _aligned_free(ptr);
+    #else
+    std::free(ptr);
+    #endif
+}
+
+void* operator new(size_t size){ return CountedAlloc(size); }
+void* operator new[](size_t size){ return CountedAlloc(size); }
+void* operator new(size_t size, std::align_val_t alignment){ return CountedAlignedAlloc(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment){ return CountedAlignedAlloc(size, (size_t)alignment); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { CountedAlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { CountedAlignedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { CountedAlignedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { CountedAlignedFree(ptr); }
+
+static size_t PeakRss(){
+    #ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return counters.PeakWorkingSetSize;
+    return 0;
+    #else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    #ifdef __APPLE__
+    return (size_t)usage.ru_maxrss;
+    #else
+    return (size_t)usage.ru_maxrss * 1024;
+    #endif
+    #endif
+}
+
+static double Now(){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+//CORPUS GENERATION
+
+//splitmix64, so the corpora don't depend on the standard library's generators
+struct GonBenchRandom {
+    uint64_t state;
+    GonBenchRandom(uint64_t seed):state(seed){}
+
+    uint64_t Next(){
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    int Range(int count){
+        return (int)(Next() % (uint64_t)count);
+    }
+};
+
+static const char* words[] = {
+    "goblin", "archer", "sword", "shield", "fire", "ice", "stone", "forest", "castle", "river", "shadow", "crystal",
+    "ember", "storm", "iron", "silver", "ancient", "cursed", "swift", "heavy", "common", "rare", "hostile", "friendly"
+};
+static const int word_count = sizeof(words)/sizeof(words[0]);
+
+static void AppendNumberText(std::string& out, GonBenchRandom& random){
+    switch(random.Range(5)){
+        case 0: out += std::to_string(random.Range(1000)); break;
+        case 1: out += std::to_string((int64_t)(random.Next() >> 20) - (int64_t)(1ll << 43)); break;
+        case 2: out += std::to_string(random.Range(100000) / 100.0); break;
+        case 3: { char hex[32]; snprintf(hex, sizeof(hex), "0x%X", random.Range(1<<20)); out += hex; } break;
+        default: { char exp[32]; snprintf(exp, sizeof(exp), "%.3e", (random.Range(20000)-10000) * 1.7e-3); out += exp; } break;
+    }
+}
+
+static void AppendSentence(std::string& out, GonBenchRandom& random, int length){
+    out += '"';
+    for(int i = 0; i<length; i++){
+        if(i) out += ' ';
+        out += words[random.Range(word_count)];
+        if(random.Range(16) == 0) out += "\\\"";
+        if(random.Range(32) == 0) out += "\\n";
+    }
+    out += '"';
+}
+
+static void AppendEntity(std::string& out, GonBenchRandom& random, size_t index, bool comments){
+    out += "entity_" + std::to_string(index) + " {\n";
+    if(comments) out += "    # " + std::string(words[random.Range(word_count)]) + " entity, tuned by hand\n";
+    out += "    type " + std::string(words[random.Range(word_count)]) + "\n";
+    out += "    sprite \"sprites/" + std::string(words[random.Range(word_count)]) + "_" + std::to_string(index) + ".png\"\n";
+    if(comments) out += "    # spawn position\n";
+    out += "    x " + std::to_string(random.Range(5000)) + " y " + std::to_string(random.Range(5000)) + "\n";
+    out += "    hp " + std::to_string(random.Range(500)) + "\n";
+    if(comments) out += "    # balance pass 3: speed was 6\n";
+    out += "    speed " + std::to_string(random.Range(10000) / 1000.0) + "\n";
+    out += "    tags [" + std::string(words[random.Range(word_count)]) + " " + words[random.Range(word_count)] + "]\n";
+    out += "    stats { str " + std::to_string(random.Range(20)) + " dex " + std::to_string(random.Range(20)) + " }\n";
+    out += "}\n";
+}
+
+static void GenerateWide(std::string& out, size_t target, GonBenchRandom& random){
+    for(int table = 0; out.size() < target; table++){
+        out += "table_" + std::to_string(table) + " {\n";
+        for(int field = 0; field < 50000 && out.size() < target; field++){
+            out += "    key_" + std::to_string(field) + "_" + words[random.Range(word_count)] + " ";
+            if(random.Range(2)) AppendNumberText(out, random);
+            else out += words[random.Range(word_count)];
+            out += "\n";
+        }
+        out += "}\n";
+    }
+}
+
+static void GenerateDeep(std::string& out, size_t target, GonBenchRandom& random){
+    for(int chain = 0; out.size() < target; chain++){
+        int depth = 8 + random.Range(41);
+        out += "chain_" + std::to_string(chain) + " ";
+        std::string closing;
+        for(int level = 0; level < depth; level++){
+            if(random.Range(4) == 0){
+                out += "[ " + std::to_string(level) + " ";
+                closing += ']';
+            } else {
+                out += "{ level " + std::to_string(level) + " name " + words[random.Range(word_count)] + " child ";
+                closing += '}';
+            }
+        }
+        out += "leaf";
+        for(size_t i = closing.size(); i-- > 0;){
+            out += ' ';
+            out += closing[i];
+        }
+        out += "\n";
+    }
+}
+
+static void GenerateStrings(std::string& out, size_t target, GonBenchRandom& random){
+    for(size_t index = 0; out.size() < target; index++){
+        out += "text_" + std::to_string(index) + " {\n    title ";
+        AppendSentence(out, random, 3 + random.Range(4));
+        out += "\n    body ";
+        AppendSentence(out, random, 20 + random.Range(60));
+        out += "\n    lines [";
+        for(int i = random.Range(6); i >= 0; i--){
+            out += ' ';
+            AppendSentence(out, random, 4 + random.Range(10));
+        }
+        out += " ]\n}\n";
+    }
+}
+
+static void GenerateNumbers(std::string& out, size_t target, GonBenchRandom& random){
+    for(size_t index = 0; out.size() < target; index++){
+        out += "curve_" + std::to_string(index) + " [";
+        for(int i = 0; i<256; i++){
+            out += ' ';
+            AppendNumberText(out, random);
+        }
+        out += " ]\n";
+    }
+}
+
+static void GenerateDupKeys(std::string& out, size_t target, GonBenchRandom& random){
+    for(size_t index = 0; out.size() < target; index++){
+        out += "spawns_" + std::to_string(index) + " {\n";
+        for(int i = 0; i<64; i++){
+            out += "    spawn " + std::string(words[random.Range(word_count)]) + " wave " + std::to_string(random.Range(10)) + " at " + std::to_string(random.Range(100)) + "\n";
+        }
+        out += "}\n";
+    }
+}
+
+static void GenerateJson(std::string& out, size_t target, GonBenchRandom& random){
+    out += "{\n";
+    for(size_t index = 0; out.size() < target; index++){
+        if(index) out += ",\n";
+        out += "  \"entity_" + std::to_string(index) + "\": {\"type\": \"" + words[random.Range(word_count)] + "\", ";
+        out += "\"x\": " + std::to_string(random.Range(5000)) + ", \"y\": " + std::to_string(random.Range(5000)) + ", ";
+        out += "\"speed\": " + std::to_string(random.Range(10000) / 1000.0) + ", \"alive\": " + (random.Range(2) ? "true" : "false") + ", ";
+        out += "\"tags\": [\"" + std::string(words[random.Range(word_count)]) + "\", \"" + words[random.Range(word_count)] + "\"], ";
+        out += "\"stats\": {\"str\": " + std::to_string(random.Range(20)) + ", \"dex\": " + std::to_string(random.Range(20)) + "}}";
+    }
+    out += "\n}\n";
+}
+
+static void GenerateEntities(std::string& out, size_t target, GonBenchRandom& random, bool comments){
+    for(size_t index = 0; out.size() < target; index++){
+        AppendEntity(out, random, index, comments);
+    }
+}
+
+struct GonBenchCorpus {
+    const char* name;
+    void (*generate)(std::string& out, size_t target, GonBenchRandom& random);
+};
+
+static const GonBenchCorpus corpora[] = {
+    {"wide", GenerateWide},
+    {"deep", GenerateDeep},
+    {"strings", GenerateStrings},
+    {"numbers", GenerateNumbers},
+    {"dupkeys", GenerateDupKeys},
+    {"json", GenerateJson},
+    {"comments", [](std::string& out, size_t target, GonBenchRandom& random){ GenerateEntities(out, target, random, true); }},
+};
+
+
+//BENCHMARKS
+
+struct GonBenchResult {
+    std::string corpus;
+    size_t size;
+    std::string bench;
+    double best_seconds;
+    double median_seconds;
+    double bytes;       //bytes processed per run (for MB/s), 0 for lookups
+    double operations;  //operations per run (for ns/op), 0 if it's not a per-operation benchmark
+    size_t allocations; //during one run
+    size_t allocated_bytes;
+    size_t peak_rss;
+};
+
+//runs setup (untimed) then run, repeat times, and records the allocations of the first run
+template<class Setup, class Run>
+static GonBenchResult Measure(int repeat, Setup setup, Run run){
+    GonBenchResult res = GonBenchResult();
+    std::vector<double> times;
+    for(int i = 0; i<repeat; i++){
+        setup();
+        size_t count = allocation_count, bytes = allocation_bytes;
+        double start = Now();
+        run();
+        times.push_back(Now() - start);
+        if(i == 0){
+            res.allocations = allocation_count - count;
+            res.allocated_bytes = allocation_bytes - bytes;
+        }
+    }
+    std::sort(times.begin(), times.end());
+    res.best_seconds = times.front();
+    res.median_seconds = times[times.size()/2];
+    res.peak_rss = PeakRss();
+    return res;
+}
+
+//up to max_keys (object, key) pairs that exist, from all over the tree
+static void CollectLookups(const GonObject& obj, std::vector<std::pair<const GonObject*, std::string>>& out, GonBenchRandom& random, size_t max_keys){
+    if(obj.type == GonObject::FieldType::OBJECT){
+        for(const GonObject& child : obj.children_array){
+            if(out.size() < max_keys) out.push_back(std::make_pair(&obj, std::string(child.name)));
+            else out[random.Next() % out.size()] = std::make_pair(&obj, std::string(child.name));
+        }
+    }
+    for(const GonObject& child : obj.children_array){
+        CollectLookups(child, out, random, max_keys);
+    }
+}
+
+//a path from the root, each step is a field name or (if the name is empty) an array index
+struct GonBenchPath {
+    std::vector<std::pair<std::string, int>> steps;
+    std::string text;
+};
+
+//up to max_paths paths 1-4 steps deep that exist, from all over the tree
+static void CollectPaths(const GonObject& obj, GonBenchPath& prefix, std::vector<GonBenchPath>& out, GonBenchRandom& random, size_t max_paths){
+    if(prefix.steps.size() == 4) return;
+    for(int i = 0; i<(int)obj.children_array.size(); i++){
+        const GonObject& child = obj.children_array[i];
+        GonBenchPath path = prefix;
+        if(obj.type == GonObject::FieldType::OBJECT){
+            //operator[] finds the last of duplicate names, so only the last one is the same field for both
+            if(&obj[child.name] != &child) continue;
+            path.steps.push_back(std::make_pair(std::string(child.name), 0));
+            if(!path.text.empty()) path.text += '.';
+            path.text += '"';
+            for(char c : child.name){
+                if(c == '"' || c == '\\') path.text += '\\';
+                path.text += c;
+            }
+            path.text += '"';
+        } else {
+            path.steps.push_back(std::make_pair(std::string(), i));
+            path.text += "[" + std::to_string(i) + "]";
+        }
+        if(out.size() < max_paths) out.push_back(path);
+        else out[random.Next() % out.size()] = path;
+        CollectPaths(child, path, out, random, max_paths);
+    }
+}
+
+static void RunCorpus(const GonBenchCorpus& corpus, size_t size, int repeat, const std::string& write_dir, std::vector<GonBenchResult>& results){
+    GonBenchRandom random(0x60A1 + size);
+    std::string text;
+    text.reserve(size + 4096);
+    corpus.generate(text, size, random);
+
+    if(!write_dir.empty()){
+        std::ofstream(write_dir + "/" + corpus.name + "_" + std::to_string(size) + (std::string(corpus.name) == "json" ? ".json" : ".gon"), std::ios::binary) << text;
+    }
+
+    auto Add = [&](const char* bench, GonBenchResult res, double bytes, double operations){
+        res.corpus = corpus.name;
+        res.size = size;
+        res.bench = bench;
+        res.bytes = bytes;
+        res.operations = operations;
+        results.push_back(res);
+    };
+
+    GonObject tree;
+    Add("parse", Measure(repeat, [&]{ tree = GonObject(); }, [&]{ tree = GonObject::LoadFromBuffer(text); }), (double)text.size(), 0);
+
+    std::vector<std::pair<const GonObject*, std::string>> lookups;
+    CollectLookups(tree, lookups, random, 100000);
+    const int lookup_rounds = std::max<int>(1, (int)(1000000 / std::max<size_t>(1, lookups.size())));
+    size_t found = 0;
+    Add("lookup", Measure(repeat, []{}, [&]{
+        for(int round = 0; round<lookup_rounds; round++){
+            for(auto& lookup : lookups) found += (*lookup.first)[lookup.second].type != GonObject::FieldType::NULLGON;
+        }
+    }), 0, (double)lookups.size() * lookup_rounds);
+
+    std::vector<GonBenchPath> paths;
+    GonBenchPath root_path;
+    CollectPaths(tree, root_path, paths, random, 20000);
+    std::vector<GonPath> compiled;
+    GonPathBatch batch;
+    for(const GonBenchPath& path : paths){
+        compiled.push_back(GonPath(path.text));
+        batch.Add(compiled.back());
+    }
+    const int path_rounds = std::max<int>(1, (int)(200000 / std::max<size_t>(1, paths.size())));
+    const GonObject& const_tree = tree;
+    size_t path_found = 0;
+    Add("chain", Measure(repeat, []{}, [&]{
+        for(int round = 0; round<path_rounds; round++){
+            for(const GonBenchPath& path : paths){
+                const GonObject* field = &const_tree;
+                for(auto& step : path.steps) field = step.first.empty() ? &(*field)[step.second] : &(*field)[step.first];
+                path_found += field->type != GonObject::FieldType::NULLGON;
+            }
+        }
+    }), 0, (double)paths.size() * path_rounds);
+    Add("path", Measure(repeat, []{}, [&]{
+        for(int round = 0; round<path_rounds; round++){
+            for(const GonPath& path : compiled) path_found += path(const_tree).type != GonObject::FieldType::NULLGON;
+        }
+    }), 0, (double)paths.size() * path_rounds);
+    std::vector<const GonObject*> batch_results;
+    Add("pathbatch", Measure(repeat, []{}, [&]{
+        for(int round = 0; round<path_rounds; round++){
+            batch.Evaluate(const_tree, batch_results);
+            path_found += batch_results.size();
+        }
+    }), 0, (double)paths.size() * path_rounds);
+
+    std::string saved;
+    Add("save", Measure(repeat, [&]{ saved = std::string(); }, [&]{ saved = tree.GetOutStr(); }), 0, 0);
+    results.back().bytes = (double)saved.size();
+    saved = std::string();
+
+    GonObject patch;
+    patch.type = tree.type;
+    for(int i = 0; i<tree.size(); i += 4){
+        patch.InsertChild(tree[i]);
+    }
+    double patch_bytes = (double)patch.GetOutStr().size();
+    GonObject target;
+    Add("deepmerge", Measure(repeat, [&]{ target = tree; }, [&]{ target.DeepMerge(patch); }), patch_bytes, 0);
+    Add("patchmerge", Measure(repeat, [&]{ target = tree; }, [&]{ target.PatchMerge(patch); }), patch_bytes, 0);
+    target = GonObject();
+
+    GonOverlay overlay = {&tree, &patch};
+    Add("overlay", Measure(repeat, []{}, [&]{
+        for(int round = 0; round<path_rounds; round++){
+            for(const GonBenchPath& path : paths){
+                GonOverlay field = overlay;
+                for(auto& step : path.steps) field = step.first.empty() ? field[step.second] : field[step.first];
+                path_found += field.Exists();
+            }
+        }
+    }), 0, (double)paths.size() * path_rounds);
+    GonObject flattened;
+    Add("flatten", Measure(repeat, [&]{ flattened = GonObject(); }, [&]{ flattened = overlay.Flatten(); }), (double)text.size(), 0);
+
+    if(found == 0 && !lookups.empty()) std::cerr << "gon_bench: lookups found nothing in " << corpus.name << "\n";
+    if(path_found == 0 && !paths.empty()) std::cerr << "gon_bench: paths found nothing in " << corpus.name << "\n";
+}
+
+//"512", "64KB", "4MB", "1GB" (the B is optional)
+static size_t ParseSize(const std::string& str){
+    char* unit;
+    size_t res = (size_t)std::strtoull(str.c_str(), &unit, 10);
+    if(*unit == 'K' || *unit == 'k') res <<= 10;
+    else if(*unit == 'M' || *unit == 'm') res <<= 20;
+    else if(*unit == 'G' || *unit == 'g') res <<= 30;
+    return res;
+}
+
+static std::vector<std::string> SplitList(const std::string& str){
+    std::vector<std::string> res;
+    std::stringstream stream(str);
+    std::string item;
+    while(std::getline(stream, item, ',')) if(!item.empty()) res.push_back(item);
+    return res;
+}
+
+int main(int argc, char** argv){
+    std::vector<std::string> sizes = {"64KB", "4MB"};
+    std::vector<std::string> names;
+    int repeat = 5;
+    bool json = false;
+    std::string write_dir;
+    for(int i = 1; i<argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--sizes" && i+1 < argc) sizes = SplitList(argv[++i]);
+        else if(arg == "--corpora" && i+1 < argc) names = SplitList(argv[++i]);
+        else if(arg == "--repeat" && i+1 < argc) repeat = std::max(1, atoi(argv[++i]));
+        else if(arg == "--json") json = true;
+        else if(arg == "--write-corpus" && i+1 < argc) write_dir = argv[++i];
+        else {
+            std::cerr << "usage: gon_bench [--sizes 64KB,4MB] [--corpora wide,deep,strings,numbers,dupkeys,json,comments] [--repeat 5] [--json] [--write-corpus dir]\n";
+            return 1;
+        }
+    }
+
+    std::vector<GonBenchResult> results;
+    for(const std::string& size : sizes){
+        for(const GonBenchCorpus& corpus : corpora){
+            if(!names.empty() && std::find(names.begin(), names.end(), corpus.name) == names.end()) continue;
+            size_t first = results.size();
+            try {
+                RunCorpus(corpus, ParseSize(size), repeat, write_dir, results);
+            } catch(const std::string& error){
+                std::cerr << "gon_bench: " << corpus.name << " " << size << ": " << error << "\n";
+                return 1;
+            }
+
+            for(size_t i = first; i<results.size(); i++){
+                const GonBenchResult& res = results[i];
+                double mb_per_s = res.bytes > 0 ? res.bytes / res.best_seconds / (1<<20) : 0;
+                double ns_per_op = res.operations > 0 ? res.best_seconds * 1e9 / res.operations : 0;
+                char line[512];
+                if(json){
+                    snprintf(line, sizeof(line), "{\"corpus\":\"%s\",\"size\":%zu,\"bench\":\"%s\",\"best_ms\":%.4f,\"median_ms\":%.4f,\"mb_per_s\":%.2f,\"ns_per_op\":%.2f,\"allocations\":%zu,\"allocated_bytes\":%zu,\"peak_rss\":%zu}",
+                        res.corpus.c_str(), res.size, res.bench.c_str(), res.best_seconds*1e3, res.median_seconds*1e3, mb_per_s, ns_per_op, res.allocations, res.allocated_bytes, res.peak_rss);
+                } else {
+                    snprintf(line, sizeof(line), "%-9s %10zu %-11s %10.3f ms %9.2f MB/s %8.2f ns/op %10zu allocs %12zu bytes %6zu MB rss",
+                        res.corpus.c_str(), res.size, res.bench.c_str(), res.best_seconds*1e3, mb_per_s, ns_per_op, res.allocations, res.allocated_bytes, res.peak_rss >> 20);
+                }
+                std::cout << line << std::endl;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,287 @@
+//Glaiel Object Notation
+//typed binding from gon fields to c++ structs
+
+#pragma once
+#include "gon.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+//usage (at global scope, after the struct is defined):
+//    struct Upgrade { int cost = 0; double speed = 1; };
+//    GON_BIND(Upgrade, cost, speed)
+//
+//    struct Stats { int hp = 100; double speed = 1; std::vector<std::string> tags; std::optional<Upgrade> upgrade; };
+//    GON_BIND(Stats, hp, speed, tags, upgrade)
+//
+//    Stats stats;
+//    GonBindResult res = GonBind(obj["stats"], stats);
+//    res.Check(); //or inspect res.missing / res.mistyped yourself
+//
+//supported member types: integers, floating point, bool, std::string, other bound structs,
+//std::vector<T> (from arrays), std::map/std::unordered_map<std::string, T> (from objects) and std::optional<T>
+//integer members only take whole numbers that fit in the member type, anything else is reported as mistyped
+//missing fields keep whatever value the member already had (so in-class initializers act as defaults) and are listed in GonBindResult::missing,
+//except std::optional members, which are reset to nullopt and not reported
+//a null value counts as missing
+//
+//the binder walks each object's children once and matches names against the field list, so there are no hash lookups
+//and last_accessed_named_field is never touched. duplicate fields resolve to the last one, same as operator[]
+
+template<class T>
+struct GonBinding; //specialized by GON_BIND, or by hand with a static constexpr Fields() returning a tuple of GonBindField
+
+template<class T, class M>
+struct GonBindField {
+    std::string_view name;
+    M T::* member;
+};
+
+template<class T, class M>
+constexpr GonBindField<T, M> MakeGonBindField(std::string_view name, M T::* member){
+    return GonBindField<T, M>{name, member};
+}
+
+struct GonBindResult {
+    std::vector<std::string> missing;  //paths of fields that did not exist (members left at their defaults)
+    std::vector<std::string> mistyped; //paths of fields that exist but could not be converted to the member type, with the reason
+
+    bool ok() const {
+        return missing.empty() && mistyped.empty();
+    }
+
+    std::string Message() const {
+        std::string msg;
+        for(auto& field : missing){
+            msg += "GON ERROR: Field \""+field+"\" does not exist\n";
+        }
+        for(auto& field : mistyped){
+            msg += "GON ERROR: Field "+field+"\n";
+        }
+        return msg;
+    }
+
+    //reports every problem at once through GonObject::ErrorCallback
+    void Check() const {
+        if(!ok()) GonObject::ErrorCallback(Message());
+    }
+};
+
+//the path to the field being read, only turned into a string when something needs to be reported
+struct GonBindPath {
+    const GonBindPath* parent;
+    std::string_view name;
+    int index;
+
+    std::string ToString() const {
+        std::string res = parent?parent->ToString():"";
+        if(index >= 0){
+            res += "["+std::to_string(index)+"]";
+        } else if(!name.empty()){
+            if(!res.empty()) res += ".";
+            res += name;
+        }
+        return res;
+    }
+};
+
+class GonBinder {
+    template<class T, class = void> struct IsBound : std::false_type {};
+    template<class T> struct IsBound<T, std::void_t<decltype(GonBinding<T>::Fields())>> : std::true_type {};
+
+    template<class T> struct IsOptional : std::false_type {};
+    template<class T> struct IsOptional<std::optional<T>> : std::true_type {};
+
+    template<class T> struct IsVector : std::false_type {};
+    template<class T, class A> struct IsVector<std::vector<T, A>> : std::true_type {};
+
+    template<class T> struct IsStringMap : std::false_type {};
+    template<class T, class C, class A> struct IsStringMap<std::map<std::string, T, C, A>> : std::true_type {};
+    template<class T, class H, class E, class A> struct IsStringMap<std::unordered_map<std::string, T, H, E, A>> : std::true_type {};
+
+    template<class T> struct DependentFalse : std::false_type {};
+
+    static void Mistyped(const GonBindPath& path, const char* what, GonBindResult& result){
+        result.mistyped.push_back("\""+path.ToString()+"\" "+what);
+    }
+
+    //int_data is an int64_t, so this is every integer member type apart from the top half of uint64_t
+    template<class T>
+    static bool InRange(int64_t value){
+        if constexpr(std::is_signed<T>::value){
+            return value >= (int64_t)std::numeric_limits<T>::min() && value <= (int64_t)std::numeric_limits<T>::max();
+        } else {
+            return value >= 0 && (uint64_t)value <= (uint64_t)std::numeric_limits<T>::max();
+        }
+    }
+
+    public:
+        template<class T>
+        static void ReadValue(const GonObject& obj, T& out, const GonBindPath& path, GonBindResult& result){
+            if constexpr(IsOptional<T>::value){
+                typename T::value_type value{};
+                if(ReadValue(obj, value, path, result, 0)) out = std::move(value);
+            } else if constexpr(std::is_same<T, bool>::value){
+                if(obj.type != GonObject::FieldType::BOOL) return Mistyped(path, "is not a bool", result);
+                out = obj.bool_data;
+            } else if constexpr(std::is_integral<T>::value){
+                if(obj.type != GonObject::FieldType::NUMBER) return Mistyped(path, "is not a number", result);
+                if(std::trunc(obj.float_data) != obj.float_data) return Mistyped(path, "is not a whole number", result);
+                if((double)obj.int_data != obj.float_data || !InRange<T>(obj.int_data)) return Mistyped(path, "is out of range", result);
+                out = (T)obj.int_data;
+            } else if constexpr(std::is_floating_point<T>::value){
+                if(obj.type != GonObject::FieldType::NUMBER) return Mistyped(path, "is not a number", result);
+                out = (T)obj.float_data;
+            } else if constexpr(std::is_same<T, std::string>::value){
+                if(obj.type != GonObject::FieldType::STRING && obj.type != GonObject::FieldType::NUMBER && obj.type != GonObject::FieldType::BOOL) return Mistyped(path, "is not a string", result);
+                out.assign(obj.string_data.data(), obj.string_data.size());
+            } else if constexpr(IsVector<T>::value){
+                if(obj.type != GonObject::FieldType::ARRAY) return Mistyped(path, "is not an array", result);
+                out.clear();
+                out.resize(obj.children_array.size());
+                for(int i = 0; i<(int)obj.children_array.size(); i++){
+                    GonBindPath element_path = {&path, "", i};
+                    ReadValue(obj.children_array[i], out[i], element_path, result);
+                }
+            } else if constexpr(IsStringMap<T>::value){
+                if(obj.type != GonObject::FieldType::OBJECT) return Mistyped(path, "is not an object", result);
+                out.clear();
+                for(const GonObject& child : obj.children_array){
+                    GonBindPath child_path = {&path, child.name, -1};
+                    ReadValue(child, out[std::string(child.name)], child_path, result);
+                }
+            } else if constexpr(IsBound<T>::value){
+                if(obj.type != GonObject::FieldType::OBJECT) return Mistyped(path, "is not an object", result);
+                ReadStruct(obj, out, path, result);
+            } else {
+                static_assert(DependentFalse<T>::value, "GonBind: member type is not supported, and has no GON_BIND");
+            }
+        }
+
+        //optionals are only engaged when the value could actually be read
+        template<class T>
+        static bool ReadValue(const GonObject& obj, T& out, const GonBindPath& path, GonBindResult& result, int){
+            size_t errors = result.mistyped.size();
+            ReadValue(obj, out, path, result);
+            return result.mistyped.size() == errors;
+        }
+
+        template<class T>
+        static void ReadStruct(const GonObject& obj, T& out, const GonBindPath& path, GonBindResult& result){
+            constexpr auto fields = GonBinding<T>::Fields();
+            constexpr size_t count = std::tuple_size<decltype(fields)>::value;
+
+            //find the last child with each field name (matching operator[]) in a single pass over the children
+            const GonObject* found[count > 0 ? count : 1] = {};
+            for(const GonObject& child : obj.children_array){
+                std::string_view child_name = child.name;
+                size_t index = 0;
+                std::apply([&](const auto&... field){
+                    ((field.name == child_name ? (void)(found[index] = &child) : (void)0, index++), ...);
+                }, fields);
+            }
+
+            size_t index = 0;
+            std::apply([&](const auto&... field){
+                (ReadField(found[index++], out.*(field.member), field.name, path, result), ...);
+            }, fields);
+        }
+
+    private:
+        template<class M>
+        static void ReadField(const GonObject* child, M& member, std::string_view name, const GonBindPath& parent, GonBindResult& result){
+            GonBindPath path = {&parent, name, -1};
+            if(!child || child->type == GonObject::FieldType::NULLGON){
+                if constexpr(IsOptional<M>::value){
+                    member.reset();
+                } else {
+                    result.missing.push_back(path.ToString());
+                }
+                return;
+            }
+
+            if constexpr(IsOptional<M>::value){
+                typename M::value_type value{};
+                if(ReadValue(*child, value, path, result, 0)) member = std::move(value);
+            } else {
+                ReadValue(*child, member, path, result);
+            }
+        }
+};
+
+//reads obj into out, collecting every missing and mistyped field instead of stopping at the first one
+template<class T>
+GonBindResult GonBind(const GonObject& obj, T& out){
+    GonBindResult result;
+    GonBindPath root = {nullptr, std::string_view(obj.name), -1};
+    GonBinder::ReadValue(obj, out, root, result);
+    return result;
+}
+
+//parses into a scratch arena, binds, then drops the whole intermediate tree at once
+template<class T>
+GonBindResult GonBindFromBuffer(const std::string& buffer, T& out){
+    std::pmr::monotonic_buffer_resource arena;
+    GonObject obj = GonObject::LoadFromBuffer(buffer, &arena);
+    return GonBind(obj, out);
+}
+template<class T>
+GonBindResult GonBindFromFile(const std::string& filename, T& out){
+    std::pmr::monotonic_buffer_resource arena;
+    GonObject obj = GonObject::Load(filename, &arena);
+    return GonBind(obj, out);
+}
+
+#define GON_BIND_FIELD(Type, field) MakeGonBindField(#field, &Type::field)
+#define GON_BIND_EXPAND(x) x
+#define GON_BIND_FOR_EACH_1(M, T, a) M(T, a)
+#define GON_BIND_FOR_EACH_2(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_1(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_3(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_2(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_4(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_3(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_5(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_4(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_6(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_5(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_7(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_6(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_8(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_7(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_9(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_8(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_10(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_9(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_11(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_10(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_12(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_11(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_13(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_12(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_14(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_13(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_15(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_14(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_16(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_15(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_17(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_16(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_18(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_17(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_19(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_18(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_20(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_19(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_21(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_20(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_22(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_21(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_23(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_22(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_24(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_23(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_25(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_24(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_26(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_25(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_27(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_26(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_28(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_27(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_29(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_28(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_30(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_29(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_31(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_30(M, T, __VA_ARGS__))
+#define GON_BIND_FOR_EACH_32(M, T, a, ...) M(T, a), GON_BIND_EXPAND(GON_BIND_FOR_EACH_31(M, T, __VA_ARGS__))
+#define GON_BIND_PICK(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, NAME, ...) NAME
+#define GON_BIND_FOR_EACH(M, T, ...) GON_BIND_EXPAND(GON_BIND_PICK(__VA_ARGS__, GON_BIND_FOR_EACH_32, GON_BIND_FOR_EACH_31, GON_BIND_FOR_EACH_30, GON_BIND_FOR_EACH_29, GON_BIND_FOR_EACH_28, GON_BIND_FOR_EACH_27, GON_BIND_FOR_EACH_26, GON_BIND_FOR_EACH_25, GON_BIND_FOR_EACH_24, GON_BIND_FOR_EACH_23, GON_BIND_FOR_EACH_22, GON_BIND_FOR_EACH_21, GON_BIND_FOR_EACH_20, GON_BIND_FOR_EACH_19, GON_BIND_FOR_EACH_18, GON_BIND_FOR_EACH_17, GON_BIND_FOR_EACH_16, GON_BIND_FOR_EACH_15, GON_BIND_FOR_EACH_14, GON_BIND_FOR_EACH_13, GON_BIND_FOR_EACH_12, GON_BIND_FOR_EACH_11, GON_BIND_FOR_EACH_10, GON_BIND_FOR_EACH_9, GON_BIND_FOR_EACH_8, GON_BIND_FOR_EACH_7, GON_BIND_FOR_EACH_6, GON_BIND_FOR_EACH_5, GON_BIND_FOR_EACH_4, GON_BIND_FOR_EACH_3, GON_BIND_FOR_EACH_2, GON_BIND_FOR_EACH_1)(M, T, __VA_ARGS__))
+
+//declares the field list of a struct (up to 32 fields), must be used at global scope
+#define GON_BIND(Type, ...) \
+    template<> struct GonBinding<Type> { \
+        static constexpr auto Fields(){ \
+            return std::make_tuple(GON_BIND_FOR_EACH(GON_BIND_FIELD, Type, __VA_ARGS__)); \
+        } \
+    };
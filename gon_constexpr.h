@@ -0,0 +1,474 @@
+//Glaiel Object Notation
+//compile-time parsing of embedded gon literals (C++20)
+
+#pragma once
+#include "gon_static.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if __cplusplus < 202002L
+#error "gon_constexpr.h needs C++20"
+#endif
+
+//parses a string literal into static read-only tables at compile time, with the same grammar as GonObject::LoadFromBuffer:
+//
+//    static constexpr auto defaults = GonStatic<R"(
+//        hp 100
+//        speed 2.5
+//        tags [melee common]
+//    )">();
+//    static_assert(defaults.Root()["hp"].Int() == 100);
+//    double speed = defaults.Root()["speed"].Number();
+//
+//a syntax error in the literal is a compile error pointing at the line in this file that describes it
+//(unlike the runtime loader, tokens after an unmatched '}' are an error here instead of being dropped)
+//the result must have static storage duration (namespace scope or static constexpr) for Root() to be usable in constant expressions
+//numbers are converted with a constexpr parser that is exact for integers and for decimals with up to 15 significant digits and
+//exponents within 1e±22, longer decimals can differ from strtod in the last bit
+//hex floats (and hex integers too big for int64, which strtod would read as floats) are a compile error instead of silently becoming strings
+//the compiler's constexpr limits apply (gcc evaluates at most 262144 iterations per loop by default, see -fconstexpr-loop-limit)
+
+//string literal as a template argument
+template<size_t N>
+struct GonLiteral {
+    char text[N];
+
+    constexpr GonLiteral(const char (&str)[N]){
+        for(size_t i = 0; i<N; i++) text[i] = str[i];
+    }
+    constexpr std::string_view View() const {
+        return std::string_view(text, N-1);
+    }
+};
+
+template<size_t NodeCount, size_t PoolSize, size_t KeyCount>
+struct GonStaticTables {
+    std::array<GonStaticNode, NodeCount> nodes;
+    std::array<char, PoolSize> pool;
+    std::array<uint32_t, KeyCount == 0 ? 1 : KeyCount> keys;
+
+    constexpr GonStaticView Root() const {
+        return GonStaticView(nodes.data(), pool.data(), keys.data(), 0);
+    }
+    constexpr GonStaticView operator[](std::string_view child) const {
+        return Root()[child];
+    }
+};
+
+//compile-time version of Tokenize + LoadFromTokens + ClassifyScalar, working in transient constexpr vectors
+struct GonStaticParser {
+    struct TempNode {
+        GonObject::FieldType type;
+        bool bool_data;
+        std::string name;
+        std::string string_data;
+        int64_t int_data;
+        double float_data;
+        std::vector<int> children;
+    };
+
+    std::vector<std::string> tokens;
+    size_t current;
+    std::vector<TempNode> temp;
+
+    std::vector<GonStaticNode> nodes;
+    std::string pool;
+    std::vector<uint32_t> keys;
+
+    static constexpr bool IsWhitespace(char c){
+        return c==' '||c=='\n'||c=='\r'||c=='\t';
+    }
+    static constexpr bool IsSymbol(char c){
+        return c=='='||c==','||c==':'||c=='{'||c=='}'||c=='['||c==']';
+    }
+    static constexpr bool IsIgnoredSymbol(char c){
+        return c=='='||c==','||c==':';
+    }
+
+    constexpr void Tokenize(std::string_view data){
+        bool inString = false;
+        bool inComment = false;
+        bool escaped = false;
+        std::string current_token;
+        for(size_t i = 0; i<data.size(); i++){
+            char c = data[i];
+            if(inComment){
+                if(c == '\n') inComment = false;
+                continue;
+            }
+            if(inString){
+                if(escaped){
+                    current_token += (c == 'n') ? '\n' : c;
+                    escaped = false;
+                } else if(c == '\\'){
+                    escaped = true;
+                } else if(c == '"'){
+                    tokens.push_back(current_token);
+                    current_token.clear();
+                    inString = false;
+                } else {
+                    current_token += c;
+                }
+                continue;
+            }
+
+            if(IsSymbol(c) || IsWhitespace(c) || c == '#' || c == '"'){
+                if(!current_token.empty()){
+                    tokens.push_back(current_token);
+                    current_token.clear();
+                }
+                if(IsSymbol(c) && !IsIgnoredSymbol(c)) tokens.push_back(std::string(1, c));
+                if(c == '#') inComment = true;
+                if(c == '"') inString = true;
+                continue;
+            }
+            current_token += c;
+        }
+        if(!current_token.empty()) tokens.push_back(current_token);
+    }
+
+    static constexpr bool IsSpace(char c){
+        return IsWhitespace(c)||c=='\v'||c=='\f';
+    }
+    static constexpr int DigitValue(char c){
+        if(c >= '0' && c <= '9') return c-'0';
+        if(c >= 'a' && c <= 'z') return c-'a'+10;
+        if(c >= 'A' && c <= 'Z') return c-'A'+10;
+        return 99;
+    }
+
+    //same rules as ParseInteger in gon.cpp
+    static constexpr bool ParseInteger(std::string_view str, int64_t& out){
+        size_t pos = 0;
+        while(pos < str.size() && IsSpace(str[pos])) pos++;
+        bool negative = false;
+        if(pos < str.size() && (str[pos] == '+' || str[pos] == '-')){
+            negative = str[pos] == '-';
+            pos++;
+        }
+        int base = 10;
+        if(str.size()-pos > 2 && str[pos] == '0' && (str[pos+1] == 'x' || str[pos+1] == 'X')){
+            base = 16;
+            pos += 2;
+        } else if(str.size()-pos > 1 && str[pos] == '0'){
+            base = 8;
+            pos++;
+        }
+        if(pos >= str.size()) return false;
+
+        uint64_t magnitude = 0;
+        for(; pos < str.size(); pos++){
+            int digit = DigitValue(str[pos]);
+            if(digit >= base) return false;
+            if(magnitude > (UINT64_MAX - digit) / base) return false;
+            magnitude = magnitude*base + digit;
+        }
+        if(negative){
+            if(magnitude > (uint64_t)INT64_MAX+1) return false;
+            out = (int64_t)(0-magnitude);
+        } else {
+            if(magnitude > (uint64_t)INT64_MAX) return false;
+            out = (int64_t)magnitude;
+        }
+        return true;
+    }
+
+    //what follows "0x" in a hex float strtod would accept: hex digits with an optional '.', then an optional binary exponent
+    static constexpr bool IsHexFloat(std::string_view str){
+        size_t pos = 0;
+        bool any_digits = false;
+        for(; pos < str.size() && DigitValue(str[pos]) < 16; pos++) any_digits = true;
+        if(pos < str.size() && str[pos] == '.'){
+            pos++;
+            for(; pos < str.size() && DigitValue(str[pos]) < 16; pos++) any_digits = true;
+        }
+        if(!any_digits) return false;
+        if(pos < str.size() && (str[pos] == 'p' || str[pos] == 'P')){
+            pos++;
+            if(pos < str.size() && (str[pos] == '+' || str[pos] == '-')) pos++;
+            size_t start = pos;
+            while(pos < str.size() && str[pos] >= '0' && str[pos] <= '9') pos++;
+            if(pos == start) return false;
+        }
+        return pos == str.size();
+    }
+
+    //"nan(chars)", which from_chars reads as a nan (the payload is dropped here)
+    static constexpr bool IsNanWithPayload(std::string_view str){
+        if(str.size() < 5 || !EqualsNoCase(str.substr(0, 4), "nan(") || str.back() != ')') return false;
+        for(char c : str.substr(4, str.size()-5)){
+            if(DigitValue(c) == 99 && c != '_') return false;
+        }
+        return true;
+    }
+
+    static constexpr bool EqualsNoCase(std::string_view a, std::string_view b){
+        if(a.size() != b.size()) return false;
+        for(size_t i = 0; i<a.size(); i++){
+            char c = a[i];
+            if(c >= 'A' && c <= 'Z') c = c-'A'+'a';
+            if(c != b[i]) return false;
+        }
+        return true;
+    }
+
+    static constexpr bool ParseDouble(std::string_view str, double& out){
+        size_t pos = 0;
+        while(pos < str.size() && IsSpace(str[pos])) pos++;
+        bool negative = false;
+        if(pos < str.size() && (str[pos] == '+' || str[pos] == '-')){
+            negative = str[pos] == '-';
+            pos++;
+        }
+        std::string_view rest = str.substr(pos);
+        if(EqualsNoCase(rest, "inf") || EqualsNoCase(rest, "infinity")){
+            out = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+            return true;
+        }
+        if(EqualsNoCase(rest, "nan") || IsNanWithPayload(rest)){
+            out = std::numeric_limits<double>::quiet_NaN();
+            return true;
+        }
+        if(rest.size() > 2 && rest[0] == '0' && (rest[1] == 'x' || rest[1] == 'X')){
+            int64_t value = 0;
+            if(!ParseInteger(rest, value)){
+                if(IsHexFloat(rest.substr(2))) throw "GON ERROR: hex floats are not supported in GonStatic literals";
+                return false;
+            }
+            out = negative ? -(double)value : (double)value;
+            return true;
+        }
+
+        uint64_t mantissa = 0;
+        int significant = 0;
+        int exponent = 0;
+        bool any_digits = false;
+        for(; pos < str.size() && str[pos] >= '0' && str[pos] <= '9'; pos++){
+            any_digits = true;
+            if(significant < 19){
+                mantissa = mantissa*10 + (str[pos]-'0');
+                if(mantissa != 0) significant++;
+            } else {
+                exponent++;
+            }
+        }
+        if(pos < str.size() && str[pos] == '.'){
+            pos++;
+            for(; pos < str.size() && str[pos] >= '0' && str[pos] <= '9'; pos++){
+                any_digits = true;
+                if(significant < 19){
+                    mantissa = mantissa*10 + (str[pos]-'0');
+                    if(mantissa != 0) significant++;
+                    exponent--;
+                }
+            }
+        }
+        if(!any_digits) return false;
+        if(pos < str.size() && (str[pos] == 'e' || str[pos] == 'E')){
+            pos++;
+            bool negative_exponent = false;
+            if(pos < str.size() && (str[pos] == '+' || str[pos] == '-')){
+                negative_exponent = str[pos] == '-';
+                pos++;
+            }
+            if(pos >= str.size()) return false;
+            int value = 0;
+            for(; pos < str.size() && str[pos] >= '0' && str[pos] <= '9'; pos++){
+                if(value < 100000) value = value*10 + (str[pos]-'0');
+            }
+            exponent += negative_exponent ? -value : value;
+        }
+        if(pos != str.size()) return false;
+
+        constexpr double exact_powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        double value;
+        if(mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22){
+            //both operands are exact, so the single rounding makes this correctly rounded (clinger's fast path)
+            value = exponent < 0 ? (double)mantissa / exact_powers[-exponent] : (double)mantissa * exact_powers[exponent];
+        } else {
+            long double scaled = (long double)mantissa;
+            for(; exponent > 0; exponent--) scaled *= 10;
+            for(; exponent < 0; exponent++) scaled /= 10;
+            value = (double)scaled;
+        }
+        out = negative ? -value : value;
+        return true;
+    }
+
+    static constexpr int64_t DoubleToInt64(double value){
+        if(value != value) return 0;
+        if(value >= 9223372036854775807.0) return INT64_MAX;
+        if(value <= -9223372036854775808.0) return INT64_MIN;
+        return (int64_t)value;
+    }
+
+    static constexpr void ClassifyScalar(TempNode& ret){
+        ret.type = GonObject::FieldType::STRING;
+        int64_t int_value = 0;
+        double float_value = 0;
+        bool is_int = ParseInteger(ret.string_data, int_value);
+        bool is_float = ParseDouble(ret.string_data, float_value);
+        if(is_int || is_float){
+            ret.type = GonObject::FieldType::NUMBER;
+            ret.int_data = is_int?int_value:DoubleToInt64(float_value);
+            ret.float_data = is_float?float_value:(double)int_value;
+        }
+        if(ret.string_data == "null") ret.type = GonObject::FieldType::NULLGON;
+        if(ret.string_data == "true"){
+            ret.type = GonObject::FieldType::BOOL;
+            ret.bool_data = true;
+        }
+        if(ret.string_data == "false"){
+            ret.type = GonObject::FieldType::BOOL;
+            ret.bool_data = false;
+        }
+    }
+
+    constexpr const std::string& Peek(){
+        if(current >= tokens.size()) throw "GON ERROR: missing a '}' or ']' somewhere";
+        return tokens[current];
+    }
+
+    constexpr int LoadFromTokens(){
+        int ret = (int)temp.size();
+        temp.push_back(TempNode{GonObject::FieldType::NULLGON, false, "", "", 0, 0, {}});
+
+        if(Peek() == "{"){
+            temp[ret].type = GonObject::FieldType::OBJECT;
+            current++;
+            while(Peek() != "}"){
+                std::string name = tokens[current++];
+                int child = LoadFromTokens();
+                temp[child].name = name;
+                temp[ret].children.push_back(child);
+            }
+            current++;
+        } else if(Peek() == "["){
+            temp[ret].type = GonObject::FieldType::ARRAY;
+            current++;
+            while(Peek() != "]"){
+                int child = LoadFromTokens();
+                temp[ret].children.push_back(child);
+            }
+            current++;
+        } else {
+            temp[ret].string_data = tokens[current++];
+            ClassifyScalar(temp[ret]);
+        }
+        return ret;
+    }
+
+    //builds the string pool: every distinct name and value once, NUL terminated so CString works
+    constexpr void BuildPool(std::vector<std::string>& strings, std::vector<uint32_t>& offsets){
+        for(const TempNode& node : temp){
+            strings.push_back(node.name);
+            strings.push_back(node.string_data);
+        }
+        std::sort(strings.begin(), strings.end());
+        strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+        for(const std::string& str : strings){
+            offsets.push_back((uint32_t)pool.size());
+            pool += str;
+            pool += '\0';
+        }
+    }
+    static constexpr uint32_t FindString(const std::vector<std::string>& strings, const std::vector<uint32_t>& offsets, const std::string& str){
+        return offsets[std::lower_bound(strings.begin(), strings.end(), str) - strings.begin()];
+    }
+
+    //lays the temp tree out breadth first, so each node's children are contiguous
+    constexpr void Layout(){
+        std::vector<std::string> strings;
+        std::vector<uint32_t> offsets;
+        BuildPool(strings, offsets);
+
+        std::vector<int> order;
+        order.push_back(0);
+        nodes.push_back(GonStaticNode{});
+        std::vector<uint32_t> sorted;
+        for(size_t i = 0; i<order.size(); i++){
+            const TempNode& src = temp[order[i]];
+            GonStaticNode node{};
+            node.type = src.type;
+            node.bool_data = src.bool_data;
+            node.name = FindString(strings, offsets, src.name);
+            node.name_length = (uint32_t)src.name.size();
+            node.string_data = FindString(strings, offsets, src.string_data);
+            node.string_length = (uint32_t)src.string_data.size();
+            node.int_data = src.int_data;
+            node.float_data = src.float_data;
+            node.first_child = (uint32_t)nodes.size();
+            node.child_count = (uint32_t)src.children.size();
+            for(int child : src.children){
+                order.push_back(child);
+                nodes.push_back(GonStaticNode{});
+            }
+
+            if(src.type == GonObject::FieldType::OBJECT){
+                //one entry per name sorted for binary search, the last duplicate wins like operator[]
+                sorted.clear();
+                for(uint32_t c = 0; c<node.child_count; c++) sorted.push_back(c);
+                std::sort(sorted.begin(), sorted.end(), [&](uint32_t l, uint32_t r){
+                    const std::string& lname = temp[src.children[l]].name;
+                    const std::string& rname = temp[src.children[r]].name;
+                    return lname < rname || (lname == rname && l < r);
+                });
+                node.keys = (uint32_t)keys.size();
+                for(size_t k = 0; k<sorted.size(); k++){
+                    if(k+1 < sorted.size() && temp[src.children[sorted[k]]].name == temp[src.children[sorted[k+1]]].name) continue;
+                    keys.push_back(node.first_child + sorted[k]);
+                }
+                node.key_count = (uint32_t)keys.size() - node.keys;
+            }
+            nodes[i] = node;
+        }
+    }
+
+    //fills the temp tree from an already loaded object instead of a literal (used by gon2cpp)
+    int LoadFrom(const GonObject& obj){
+        int ret = (int)temp.size();
+        temp.push_back(TempNode{obj.type, obj.bool_data, std::string(obj.name), std::string(obj.string_data), obj.int_data, obj.float_data, {}});
+        if(obj.type == GonObject::FieldType::OBJECT || obj.type == GonObject::FieldType::ARRAY){
+            for(const GonObject& child : obj.children_array){
+                int index = LoadFrom(child);
+                temp[ret].children.push_back(index);
+            }
+        }
+        return ret;
+    }
+
+    constexpr void Parse(std::string_view text){
+        tokens.push_back("{");
+        Tokenize(text);
+        tokens.push_back("}");
+        current = 0;
+        LoadFromTokens();
+        if(current != tokens.size()) throw "GON ERROR: unmatched '}' or ']'";
+        Layout();
+    }
+};
+
+template<GonLiteral Text>
+constexpr auto GonStatic(){
+    constexpr auto sizes = []{
+        GonStaticParser parser;
+        parser.Parse(Text.View());
+        return std::array<size_t, 3>{parser.nodes.size(), parser.pool.size(), parser.keys.size()};
+    }();
+
+    GonStaticParser parser;
+    parser.Parse(Text.View());
+
+    GonStaticTables<sizes[0], sizes[1], sizes[2]> tables{};
+    for(size_t i = 0; i<sizes[0]; i++) tables.nodes[i] = parser.nodes[i];
+    for(size_t i = 0; i<sizes[1]; i++) tables.pool[i] = parser.pool[i];
+    for(size_t i = 0; i<sizes[2]; i++) tables.keys[i] = parser.keys[i];
+    return tables;
+}
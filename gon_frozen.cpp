@@ -0,0 +1,634 @@
+#include "gon_frozen.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GON_FROZEN_SSE2 1
+#endif
+
+static const GonFrozen::NodeData null_node_data = {GonObject::FieldType::NULLGON, false, GonFrozen::NotPacked, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+//same conversion the parser uses for a float's int value
+static int64_t DoubleToInt64(double value){
+    if(value != value) return 0;
+    if(value >= 9223372036854775807.0) return INT64_MAX;
+    if(value <= -9223372036854775808.0) return INT64_MIN;
+    return (int64_t)value;
+}
+
+//an array can be packed if its elements are unnamed numbers whose int and float values can be rebuilt from one of them, or unnamed bools
+static GonFrozen::PackedArray PackedKind(const GonObject& array){
+    if(array.type != GonObject::FieldType::ARRAY || array.children_array.empty()) return GonFrozen::NotPacked;
+
+    bool ints = true, doubles = true, bools = true;
+    for(const GonObject& element : array.children_array){
+        if(!element.name.empty() || !element.children_array.empty()) return GonFrozen::NotPacked;
+        if(element.type == GonObject::FieldType::NUMBER){
+            bools = false;
+            double as_double = (double)element.int_data;
+            if(memcmp(&as_double, &element.float_data, sizeof(double)) != 0) ints = false; //bitwise, so -0.0 isn't packed as 0
+            if(DoubleToInt64(element.float_data) != element.int_data) doubles = false;
+        } else if(element.type == GonObject::FieldType::BOOL){
+            ints = doubles = false;
+            if(element.string_data != (element.bool_data ? "true" : "false")) bools = false;
+        } else {
+            return GonFrozen::NotPacked;
+        }
+        if(!ints && !doubles && !bools) return GonFrozen::NotPacked;
+    }
+    if(bools) return GonFrozen::PackedBools;
+    if(doubles) return GonFrozen::PackedDoubles; //preferred when both work, it's what bulk float reads want
+    return GonFrozen::PackedInts;
+}
+
+//FNV-1a, computed once per lookup, the per-bucket seeds are mixed into it afterwards
+static uint64_t HashKey(std::string_view key){
+    uint64_t hash = 14695981039346656037ull;
+    for(char c : key){
+        hash ^= (unsigned char)c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static const uint32_t DirectSlot = 0x80000000; //seed flag: the rest of the seed is the slot itself
+
+static uint32_t MixSeed(uint64_t hash, uint32_t seed){
+    uint64_t x = hash ^ ((uint64_t)seed * 0x9E3779B97F4A7C15ull);
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 29;
+    return (uint32_t)(x >> 32);
+}
+
+//hash and displace: keys are grouped into buckets by hash, then the largest buckets first get a seed that sends all of their keys to free slots
+//returns false if some bucket found no seed (the caller retries with more, smaller buckets)
+static bool BuildPerfectHash(const std::vector<std::pair<uint64_t, uint32_t>>& keys, uint32_t bucket_count, std::vector<uint32_t>& seeds_out, std::vector<uint32_t>& slots_out){
+    uint32_t key_count = (uint32_t)keys.size();
+
+    std::vector<std::vector<uint32_t>> buckets(bucket_count);
+    for(uint32_t i = 0; i<key_count; i++){
+        buckets[keys[i].first % bucket_count].push_back(i);
+    }
+    std::vector<uint32_t> order(bucket_count);
+    for(uint32_t i = 0; i<bucket_count; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b){ return buckets[a].size() > buckets[b].size(); });
+
+    seeds_out.assign(bucket_count, 0);
+    slots_out.assign(key_count, GonFrozen::NullIndex);
+    std::vector<uint32_t> bucket_slots;
+
+    uint32_t next_free = 0;
+    for(uint32_t bucket : order){
+        if(buckets[bucket].empty()) break;
+
+        //single-key buckets come last, when the table is nearly full, so they store their slot directly instead of searching for a seed
+        if(buckets[bucket].size() == 1){
+            while(slots_out[next_free] != GonFrozen::NullIndex) next_free++;
+            seeds_out[bucket] = DirectSlot | next_free;
+            slots_out[next_free] = keys[buckets[bucket][0]].second;
+            continue;
+        }
+
+        bool placed = false;
+        for(uint32_t seed = 1; seed < 4096 && !placed; seed++){
+            bucket_slots.clear();
+            placed = true;
+            for(uint32_t key : buckets[bucket]){
+                uint32_t slot = MixSeed(keys[key].first, seed) % key_count;
+                if(slots_out[slot] != GonFrozen::NullIndex || std::find(bucket_slots.begin(), bucket_slots.end(), slot) != bucket_slots.end()){
+                    placed = false;
+                    break;
+                }
+                bucket_slots.push_back(slot);
+            }
+            if(placed){
+                seeds_out[bucket] = seed;
+                for(size_t i = 0; i<bucket_slots.size(); i++){
+                    slots_out[bucket_slots[i]] = keys[buckets[bucket][i]].second;
+                }
+            }
+        }
+        if(!placed) return false;
+    }
+    return true;
+}
+
+
+GonFrozen::GonFrozen(){
+}
+
+GonFrozen::GonFrozen(const GonObject& tree){
+    //keys point into the source tree, which doesn't change while freezing
+    std::unordered_map<std::string_view, uint32_t> interned;
+    auto Intern = [&](std::string_view str) -> uint32_t {
+        auto iter = interned.find(str);
+        if(iter != interned.end()) return iter->second;
+        uint32_t offset = (uint32_t)pool.size();
+        pool.append(str.data(), str.size());
+        pool += '\0'; //so CString can point into the pool
+        interned.emplace(str, offset);
+        return offset;
+    };
+
+    auto MakeNode = [&](const GonObject& src){
+        NodeData node = null_node_data;
+        node.type = src.type;
+        node.bool_data = src.bool_data;
+        node.name = Intern(src.name);
+        node.name_length = (uint32_t)src.name.size();
+        if(!src.name.empty()) names.push_back(node.name);
+        node.string_data = Intern(src.string_data);
+        node.string_length = (uint32_t)src.string_data.size();
+        node.int_data = src.int_data;
+        node.float_data = src.float_data;
+        return node;
+    };
+
+    bool_text[0] = Intern("false");
+    bool_text[1] = Intern("true");
+
+    std::vector<const GonObject*> sources;
+    sources.push_back(&tree);
+    nodes.push_back(MakeNode(tree));
+
+    std::vector<std::pair<uint64_t, uint32_t>> keys;
+    std::vector<uint32_t> object_seeds, object_slots;
+
+    for(size_t i = 0; i<sources.size(); i++){
+        const GonObject& src = *sources[i];
+        if(src.type != GonObject::FieldType::OBJECT && src.type != GonObject::FieldType::ARRAY) continue;
+
+        PackedArray packed = PackedKind(src);
+        if(packed != NotPacked){
+            NodeData& node = nodes[i];
+            node.packed = packed;
+            node.child_count = (uint32_t)src.children_array.size();
+            if(packed == PackedBools){
+                node.first_child = (uint32_t)packed_bools.size();
+                for(const GonObject& element : src.children_array) packed_bools.push_back(element.bool_data);
+            } else {
+                node.first_child = (uint32_t)packed_text.size();
+                node.seeds = (uint32_t)(packed == PackedInts ? packed_ints.size() : packed_doubles.size());
+                for(const GonObject& element : src.children_array){
+                    packed_text.push_back(Intern(element.string_data));
+                    if(packed == PackedInts) packed_ints.push_back(element.int_data);
+                    else packed_doubles.push_back(element.float_data);
+                }
+            }
+            continue;
+        }
+
+        uint32_t first_child = (uint32_t)nodes.size();
+        nodes[i].first_child = first_child;
+        nodes[i].child_count = (uint32_t)src.children_array.size();
+        for(const GonObject& child : src.children_array){
+            sources.push_back(&child);
+            nodes.push_back(MakeNode(child));
+        }
+
+        if(src.type != GonObject::FieldType::OBJECT || src.children_map.empty()) continue;
+
+        //one key per children_map entry, so duplicate names resolve to the same child operator[] would return
+        keys.clear();
+        for(auto& entry : src.children_map){
+            keys.push_back(std::make_pair(HashKey(entry.first), first_child + entry.second));
+        }
+
+        uint32_t key_count = (uint32_t)keys.size();
+        uint32_t bucket_count = (key_count+1)/2;
+        while(!BuildPerfectHash(keys, bucket_count, object_seeds, object_slots)){
+            if(bucket_count >= key_count){
+                GonObject::ErrorCallback("GON ERROR: could not build a perfect hash while freezing (colliding keys in \""+std::string(src.name)+"\")");
+                return;
+            }
+            bucket_count = std::min(key_count, bucket_count*2);
+        }
+
+        NodeData& node = nodes[i];
+        node.seeds = (uint32_t)seeds.size();
+        node.bucket_count = bucket_count;
+        node.slots = (uint32_t)slots.size();
+        node.key_count = key_count;
+        seeds.insert(seeds.end(), object_seeds.begin(), object_seeds.end());
+        slots.insert(slots.end(), object_slots.begin(), object_slots.end());
+    }
+
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    std::sort(names.begin(), names.end(), [&](uint32_t a, uint32_t b){
+        return strcmp(pool.data()+a, pool.data()+b) < 0;
+    });
+
+    nodes.shrink_to_fit();
+    pool.shrink_to_fit();
+    names.shrink_to_fit();
+    packed_ints.shrink_to_fit();
+    packed_doubles.shrink_to_fit();
+    packed_text.shrink_to_fit();
+    packed_bools.shrink_to_fit();
+    seeds.shrink_to_fit();
+    slots.shrink_to_fit();
+}
+
+GonFrozen GonFrozen::Freeze(const GonObject& tree){
+    return GonFrozen(tree);
+}
+
+GonFrozen::Node GonFrozen::Root() const {
+    if(nodes.empty()) return Node(this, NullIndex);
+    return Node(this, 0);
+}
+GonFrozen::Node GonFrozen::operator[](std::string_view child) const {
+    return Root()[child];
+}
+
+size_t GonFrozen::NodeCount() const {
+    return nodes.size();
+}
+size_t GonFrozen::MemoryUsage() const {
+    return nodes.capacity()*sizeof(NodeData) + pool.capacity() + (seeds.capacity()+slots.capacity()+names.capacity()+packed_text.capacity())*sizeof(uint32_t)
+         + packed_ints.capacity()*sizeof(int64_t) + packed_doubles.capacity()*sizeof(double) + packed_bools.capacity()/8;
+}
+
+GonFrozen::Key GonFrozen::Intern(std::string_view key) const {
+    Key res;
+    res.hash = HashKey(key);
+    res.text = key;
+    auto iter = std::lower_bound(names.begin(), names.end(), key, [&](uint32_t name, std::string_view str){
+        return std::string_view(pool.data()+name) < str;
+    });
+    if(iter != names.end() && std::string_view(pool.data()+*iter) == key) res.name = *iter;
+    return res;
+}
+
+uint32_t GonFrozen::FindChild(const NodeData& obj, std::string_view key) const {
+    if(obj.key_count == 0) return NullIndex;
+
+    uint64_t hash = HashKey(key);
+    uint32_t seed = seeds[obj.seeds + hash % obj.bucket_count];
+    uint32_t slot = (seed & DirectSlot) ? (seed & ~DirectSlot) : MixSeed(hash, seed) % obj.key_count;
+    uint32_t child = slots[obj.slots + slot];
+
+    const NodeData& found = nodes[child];
+    if(found.name_length != key.size() || memcmp(pool.data()+found.name, key.data(), key.size()) != 0) return NullIndex;
+    return child;
+}
+
+//interned names are unique in the pool, so comparing offsets is comparing names
+uint32_t GonFrozen::FindChild(const NodeData& obj, const Key& key) const {
+    if(obj.key_count == 0 || key.name == NullIndex) return NullIndex;
+
+    uint32_t seed = seeds[obj.seeds + key.hash % obj.bucket_count];
+    uint32_t slot = (seed & DirectSlot) ? (seed & ~DirectSlot) : MixSeed(key.hash, seed) % obj.key_count;
+    uint32_t child = slots[obj.slots + slot];
+    return nodes[child].name == key.name ? child : NullIndex;
+}
+
+std::string_view GonFrozen::PoolString(uint32_t offset, uint32_t length) const {
+    return std::string_view(pool.data()+offset, length);
+}
+
+
+GonFrozen::Iterator::Iterator(const GonFrozen* doc, uint32_t index, uint32_t element):doc(doc),index(index),element(element){
+}
+GonFrozen::Node GonFrozen::Iterator::operator*() const {
+    return Node(doc, index, element);
+}
+GonFrozen::Iterator& GonFrozen::Iterator::operator++(){
+    if(element != NullIndex) element++;
+    else index++;
+    return *this;
+}
+bool GonFrozen::Iterator::operator==(const Iterator& other) const {
+    return index == other.index && element == other.element;
+}
+bool GonFrozen::Iterator::operator!=(const Iterator& other) const {
+    return !(*this == other);
+}
+
+
+GonFrozen::Node::Node():doc(nullptr),index(NullIndex),element(NullIndex){
+}
+GonFrozen::Node::Node(const GonFrozen* doc, uint32_t index, uint32_t element):doc(doc),index(index),element(element){
+}
+
+GonFrozen::NodeData GonFrozen::Node::Data() const {
+    if(!doc || index == NullIndex) return null_node_data;
+    if(element == NullIndex) return doc->nodes[index];
+
+    //rebuild a packed element the way it was before freezing
+    const NodeData& array = doc->nodes[index];
+    NodeData res = null_node_data;
+    if(array.packed == PackedBools){
+        res.type = GonObject::FieldType::BOOL;
+        res.bool_data = doc->packed_bools[array.first_child + element];
+        res.string_data = doc->bool_text[res.bool_data];
+        res.string_length = res.bool_data ? 4 : 5;
+        return res;
+    }
+    res.type = GonObject::FieldType::NUMBER;
+    res.string_data = doc->packed_text[array.first_child + element]; //string_length is left for StringView to measure
+    if(array.packed == PackedInts){
+        res.int_data = doc->packed_ints[array.seeds + element];
+        res.float_data = (double)res.int_data;
+    } else {
+        res.float_data = doc->packed_doubles[array.seeds + element];
+        res.int_data = DoubleToInt64(res.float_data);
+    }
+    return res;
+}
+std::string_view GonFrozen::Node::StringView() const {
+    if(!doc || index == NullIndex) return std::string_view();
+    NodeData data = Data();
+    if(element != NullIndex) return std::string_view(doc->pool.data() + data.string_data);
+    return doc->PoolString(data.string_data, data.string_length);
+}
+std::string_view GonFrozen::Node::Name() const {
+    if(!doc || index == NullIndex) return std::string_view();
+    return doc->PoolString(Data().name, Data().name_length);
+}
+GonObject::FieldType GonFrozen::Node::Type() const {
+    if(element != NullIndex) return doc->nodes[index].packed == PackedBools ? GonObject::FieldType::BOOL : GonObject::FieldType::NUMBER;
+    return Data().type;
+}
+
+void GonFrozen::Node::FieldError(const char* what) const {
+    std::string_view name = Name();
+    GonObject::ErrorCallback("GON ERROR: Field \""+(!name.empty()?std::string(name):GonObject::last_accessed_named_field)+"\" "+what);
+}
+
+static bool IsStringLike(GonObject::FieldType type){
+    return type == GonObject::FieldType::STRING || type == GonObject::FieldType::NUMBER || type == GonObject::FieldType::BOOL;
+}
+
+//options with error throwing
+std::string GonFrozen::Node::String() const {
+    if(Type() == GonObject::FieldType::NULLGON) FieldError("does not exist");
+    if(!IsStringLike(Type())) FieldError("is not a string");
+    return std::string(StringView());
+}
+const char* GonFrozen::Node::CString() const {
+    if(Type() == GonObject::FieldType::NULLGON) FieldError("does not exist");
+    if(!IsStringLike(Type())) FieldError("is not a string");
+    return StringView().data();
+}
+int GonFrozen::Node::Int() const {
+    return (int)Int64();
+}
+int64_t GonFrozen::Node::Int64() const {
+    if(Type() == GonObject::FieldType::NULLGON) FieldError("does not exist");
+    if(Type() != GonObject::FieldType::NUMBER) FieldError("is not a number");
+    return Data().int_data;
+}
+double GonFrozen::Node::Number() const {
+    if(Type() == GonObject::FieldType::NULLGON) FieldError("does not exist");
+    if(Type() != GonObject::FieldType::NUMBER) FieldError("is not a number");
+    return Data().float_data;
+}
+double GonFrozen::Node::Percent() const {
+    if(Type() == GonObject::FieldType::NULLGON) FieldError("does not exist");
+    if(Type() == GonObject::FieldType::NUMBER) return Data().float_data;
+    if(IsPercent()){
+        std::string_view str = StringView();
+        return strtod(std::string(str.substr(0, str.size()-1)).c_str(), nullptr) / 100.0;
+    }
+    FieldError("is not a percent");
+    return 0;
+}
+bool GonFrozen::Node::Bool() const {
+    if(Type() == GonObject::FieldType::NULLGON) FieldError("does not exist");
+    if(Type() != GonObject::FieldType::BOOL) FieldError("is not a bool");
+    return Data().bool_data;
+}
+
+//options with a default value
+std::string GonFrozen::Node::String(const std::string& _default) const {
+    if(!IsStringLike(Type())) return _default;
+    return std::string(StringView());
+}
+const char* GonFrozen::Node::CString(const char* _default) const {
+    if(!IsStringLike(Type())) return _default;
+    return StringView().data();
+}
+int GonFrozen::Node::Int(int _default) const {
+    if(Type() != GonObject::FieldType::NUMBER) return _default;
+    return (int)Data().int_data;
+}
+int64_t GonFrozen::Node::Int64(int64_t _default) const {
+    if(Type() != GonObject::FieldType::NUMBER) return _default;
+    return Data().int_data;
+}
+double GonFrozen::Node::Number(double _default) const {
+    if(Type() != GonObject::FieldType::NUMBER) return _default;
+    return Data().float_data;
+}
+double GonFrozen::Node::Percent(double _default) const {
+    if(Type() == GonObject::FieldType::NUMBER) return Data().float_data;
+    if(IsPercent()){
+        std::string_view str = StringView();
+        return strtod(std::string(str.substr(0, str.size()-1)).c_str(), nullptr) / 100.0;
+    }
+    return _default;
+}
+bool GonFrozen::Node::Bool(bool _default) const {
+    if(Type() != GonObject::FieldType::BOOL) return _default;
+    return Data().bool_data;
+}
+
+bool GonFrozen::Node::Contains(std::string_view child) const {
+    if(Type() != GonObject::FieldType::OBJECT) return false;
+    return doc->FindChild(Data(), child) != NullIndex;
+}
+bool GonFrozen::Node::ContainsNthChildWithName(std::string_view child, int index) const {
+    return NthChildWithName(child, index).Exists();
+}
+bool GonFrozen::Node::Contains(int child) const {
+    if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return true;
+    return child >= 0 && child < (int)Data().child_count;
+}
+bool GonFrozen::Node::Exists() const {
+    return Type() != GonObject::FieldType::NULLGON;
+}
+bool GonFrozen::Node::IsPercent() const {
+    if(Type() != GonObject::FieldType::STRING) return false;
+    std::string_view str = StringView();
+    if(str.empty() || str.back() != '%') return false;
+    std::string number(str.substr(0, str.size()-1));
+    char* endptr;
+    strtod(number.c_str(), &endptr);
+    return *endptr == 0;
+}
+
+//like GonPath, last_accessed_named_field is only written when a lookup misses
+GonFrozen::Node GonFrozen::Node::operator[](std::string_view child) const {
+    uint32_t found = NullIndex;
+    if(Type() == GonObject::FieldType::OBJECT) found = doc->FindChild(Data(), child);
+    if(found == NullIndex) GonObject::last_accessed_named_field = child;
+    return Node(doc, found);
+}
+bool GonFrozen::Node::Contains(const Key& child) const {
+    if(Type() != GonObject::FieldType::OBJECT) return false;
+    return doc->FindChild(Data(), child) != NullIndex;
+}
+GonFrozen::Node GonFrozen::Node::operator[](const Key& child) const {
+    uint32_t found = NullIndex;
+    if(Type() == GonObject::FieldType::OBJECT) found = doc->FindChild(Data(), child);
+    if(found == NullIndex) GonObject::last_accessed_named_field = child.text;
+    return Node(doc, found);
+}
+GonFrozen::Node GonFrozen::Node::NthChildWithName(const Key& child, int index) const {
+    if(Type() != GonObject::FieldType::OBJECT || child.name == NullIndex){
+        GonObject::last_accessed_named_field = child.text;
+        return Node(doc, NullIndex);
+    }
+    if(index == 0) return (*this)[child];
+
+    const NodeData& data = Data();
+    for(uint32_t i = data.first_child; i<data.first_child+data.child_count; i++){
+        if(doc->nodes[i].name == child.name){
+            if(index-- == 0) return Node(doc, i);
+        }
+    }
+    GonObject::last_accessed_named_field = child.text;
+    return Node(doc, NullIndex);
+}
+GonFrozen::Node GonFrozen::Node::ChildOrSelf(std::string_view child) const {
+    if(Contains(child)) return (*this)[child];
+    return *this;
+}
+GonFrozen::Node GonFrozen::Node::NthChildWithName(std::string_view child, int index) const {
+    if(Type() != GonObject::FieldType::OBJECT){
+        GonObject::last_accessed_named_field = child;
+        return Node(doc, NullIndex);
+    }
+    if(index == 0) return (*this)[child];
+
+    for(Node entry : *this){
+        if(entry.Name() == child){
+            if(index-- == 0) return entry;
+        }
+    }
+    GonObject::last_accessed_named_field = child;
+    return Node(doc, NullIndex);
+}
+GonFrozen::Node GonFrozen::Node::FieldInChildOrSelf(std::string_view child, std::string_view field) const {
+    Node res = (*this)[child][field];
+    if(res.Exists()) return res;
+    return (*this)[field];
+}
+GonFrozen::Node GonFrozen::Node::operator[](int childindex) const {
+    if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return *this;
+    const NodeData& data = doc->nodes[index];
+    if(childindex < 0 || childindex >= (int)data.child_count) return Node(doc, NullIndex);
+    if(data.packed != NotPacked) return Node(doc, index, (uint32_t)childindex);
+    return Node(doc, data.first_child + childindex);
+}
+
+int GonFrozen::Node::Size() const {
+    return size();
+}
+int GonFrozen::Node::size() const {
+    if(Type() == GonObject::FieldType::NULLGON) return 0;
+    if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return 1;//size 1, object is self
+    return (int)Data().child_count;
+}
+bool GonFrozen::Node::empty() const {
+    return Data().child_count == 0;
+}
+GonFrozen::Iterator GonFrozen::Node::begin() const {
+    if(Type() == GonObject::FieldType::NULLGON) return Iterator(doc, index, element);
+    if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return Iterator(doc, index, element);
+    const NodeData& data = doc->nodes[index];
+    if(data.packed != NotPacked) return Iterator(doc, index, 0);
+    return Iterator(doc, data.first_child);
+}
+GonFrozen::Iterator GonFrozen::Node::end() const {
+    if(Type() == GonObject::FieldType::NULLGON) return Iterator(doc, index, element);
+    if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY){
+        if(element != NullIndex) return Iterator(doc, index, element+1);
+        return Iterator(doc, index+1);
+    }
+    const NodeData& data = doc->nodes[index];
+    if(data.packed != NotPacked) return Iterator(doc, index, data.child_count);
+    return Iterator(doc, data.first_child + data.child_count);
+}
+
+size_t GonFrozen::Node::ToDoubles(double* out, size_t count) const {
+    if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return 0;
+    const NodeData& data = doc->nodes[index];
+    size_t n = std::min<size_t>(count, data.child_count);
+    if(data.packed == PackedDoubles){
+        memcpy(out, doc->packed_doubles.data() + data.seeds, n*sizeof(double));
+    } else if(data.packed == PackedInts){
+        const int64_t* src = doc->packed_ints.data() + data.seeds;
+        for(size_t i = 0; i<n; i++) out[i] = (double)src[i];
+    } else {
+        for(size_t i = 0; i<n; i++) out[i] = (*this)[(int)i].Number(0);
+    }
+    return n;
+}
+size_t GonFrozen::Node::ToFloats(float* out, size_t count) const {
+    if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return 0;
+    const NodeData& data = doc->nodes[index];
+    size_t n = std::min<size_t>(count, data.child_count);
+    if(data.packed == PackedDoubles){
+        const double* src = doc->packed_doubles.data() + data.seeds;
+        size_t i = 0;
+        #ifdef GON_FROZEN_SSE2
+        for(; i+4 <= n; i += 4){
+            __m128 low = _mm_cvtpd_ps(_mm_loadu_pd(src+i));
+            __m128 high = _mm_cvtpd_ps(_mm_loadu_pd(src+i+2));
+            _mm_storeu_ps(out+i, _mm_movelh_ps(low, high));
+        }
+        #endif
+        for(; i<n; i++) out[i] = (float)src[i];
+    } else if(data.packed == PackedInts){
+        const int64_t* src = doc->packed_ints.data() + data.seeds;
+        for(size_t i = 0; i<n; i++) out[i] = (float)src[i];
+    } else {
+        for(size_t i = 0; i<n; i++) out[i] = (float)(*this)[(int)i].Number(0);
+    }
+    return n;
+}
+size_t GonFrozen::Node::ToInt64s(int64_t* out, size_t count) const {
+    if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return 0;
+    const NodeData& data = doc->nodes[index];
+    size_t n = std::min<size_t>(count, data.child_count);
+    if(data.packed == PackedInts){
+        memcpy(out, doc->packed_ints.data() + data.seeds, n*sizeof(int64_t));
+    } else if(data.packed == PackedDoubles){
+        const double* src = doc->packed_doubles.data() + data.seeds;
+        for(size_t i = 0; i<n; i++) out[i] = DoubleToInt64(src[i]);
+    } else {
+        for(size_t i = 0; i<n; i++) out[i] = (*this)[(int)i].Int64(0);
+    }
+    return n;
+}
+
+GonObject GonFrozen::Node::Thaw() const {
+    GonObject res;
+    const NodeData& data = Data();
+    res.type = data.type;
+    res.name = Name();
+    res.string_data = StringView();
+    res.int_data = data.int_data;
+    res.float_data = data.float_data;
+    res.bool_data = data.bool_data;
+
+    if(data.type == GonObject::FieldType::OBJECT || data.type == GonObject::FieldType::ARRAY){
+        res.children_array.reserve(data.child_count);
+        for(Node child : *this){
+            res.children_array.push_back(child.Thaw());
+        }
+        for(uint32_t i = 0; i<data.key_count; i++){
+            uint32_t child = doc->slots[data.slots + i];
+            res.children_map[res.children_array[child - data.first_child].name] = (int)(child - data.first_child);
+        }
+    }
+    return res;
+}
@@ -0,0 +1,178 @@
+//Glaiel Object Notation
+//immutable compact trees with perfect hash key lookup
+
+#pragma once
+#include "gon.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//a read-only copy of a GonObject tree, for data that is never modified after loading and merging
+//nodes are stored contiguously in breadth-first order (so every node's children are adjacent), all keys and strings are
+//deduplicated into one pool, and each object's key lookup goes through a minimal perfect hash built when freezing
+//
+//    GonFrozen frozen(GonObject::Load("units.gon"));
+//    GonFrozen::Node units = frozen.Root();
+//    int hp = units["archer"]["hp"].Int();
+//
+//Node mirrors the read side of GonObject's API, but is returned by value (it's just a document pointer and an index)
+//the GonFrozen must outlive every Node taken from it
+//
+//arrays of only numbers or only bools are packed: their elements have no NodeData, just a value in a contiguous
+//int64/double/bool buffer (plus the number's text in the pool), indexing and iterating them still gives a Node per element,
+//and ToFloats/ToDoubles/ToInt64s copy them out in bulk
+class GonFrozen {
+    public:
+        static constexpr uint32_t NullIndex = 0xFFFFFFFF;
+
+        enum PackedArray : uint8_t {
+            NotPacked,
+            PackedInts,    //every element's float value is its int value
+            PackedDoubles, //every element's int value is its float value truncated
+            PackedBools
+        };
+
+        struct NodeData {
+            GonObject::FieldType type;
+            bool bool_data;
+            PackedArray packed;
+            uint32_t name;          //offset and length in the string pool
+            uint32_t name_length;
+            uint32_t string_data;
+            uint32_t string_length;
+            uint32_t first_child;   //children are nodes[first_child, first_child+child_count)
+                                    //packed numbers: element text offsets are packed_text[first_child, ...), packed bools: values are packed_bools[first_child, ...)
+            uint32_t child_count;
+            uint32_t seeds;         //objects: perfect hash displacement seeds are seeds[seeds, seeds+bucket_count)
+                                    //packed numbers: values are packed_ints or packed_doubles[seeds, seeds+child_count)
+            uint32_t bucket_count;
+            uint32_t slots;         //objects: slots[slots, slots+key_count) hold child indexes, one per unique key
+            uint32_t key_count;
+            int64_t int_data;
+            double float_data;
+        };
+
+        //a key interned in this document's string pool: equal keys share one pool offset, so lookups with a Key
+        //compare offsets instead of strings and reuse the precomputed hash (intern keys once, ex. in a static, and reuse them)
+        struct Key {
+            uint32_t name = NullIndex; //NullIndex if no field in the document has this name
+            uint64_t hash = 0;
+            std::string text;          //for error messages
+        };
+
+        class Node;
+
+        class Iterator {
+            public:
+                Iterator(const GonFrozen* doc, uint32_t index, uint32_t element = NullIndex);
+                Node operator*() const;
+                Iterator& operator++();
+                bool operator==(const Iterator& other) const;
+                bool operator!=(const Iterator& other) const;
+
+            private:
+                const GonFrozen* doc;
+                uint32_t index;
+                uint32_t element; //position in a packed array, NullIndex otherwise
+        };
+
+        class Node {
+            public:
+                Node();
+                Node(const GonFrozen* doc, uint32_t index, uint32_t element = NullIndex);
+
+                //same behavior as the GonObject functions with the same names
+                std::string String() const;
+                const char* CString() const;
+                int Int() const;
+                int64_t Int64() const;
+                double Number() const;
+                double Percent() const;
+                bool Bool() const;
+
+                std::string String(const std::string& _default) const;
+                const char* CString(const char* _default) const;
+                int Int(int _default) const;
+                int64_t Int64(int64_t _default) const;
+                double Number(double _default) const;
+                double Percent(double _default) const;
+                bool Bool(bool _default) const;
+
+                bool Contains(std::string_view child) const;
+                bool ContainsNthChildWithName(std::string_view child, int index) const;
+                bool Contains(int child) const;
+                bool Exists() const;
+                bool IsPercent() const;
+
+                Node operator[](std::string_view child) const;
+                Node ChildOrSelf(std::string_view child) const;
+                Node NthChildWithName(std::string_view child, int index) const;
+                Node FieldInChildOrSelf(std::string_view child, std::string_view field) const;
+                Node operator[](int childindex) const;
+
+                //same as above, with keys from Intern
+                bool Contains(const Key& child) const;
+                Node operator[](const Key& child) const;
+                Node NthChildWithName(const Key& child, int index) const;
+
+                int Size() const;
+                int size() const;
+                bool empty() const;
+                Iterator begin() const;
+                Iterator end() const;
+
+                std::string_view Name() const;
+                GonObject::FieldType Type() const;
+
+                //bulk reads of an array, returns how many elements were written (at most count)
+                //elements that aren't numbers read as 0, packed arrays are converted straight from their buffers
+                size_t ToFloats(float* out, size_t count) const;
+                size_t ToDoubles(double* out, size_t count) const;
+                size_t ToInt64s(int64_t* out, size_t count) const;
+
+                //copies the subtree back into a regular, mutable GonObject
+                GonObject Thaw() const;
+
+            private:
+                NodeData Data() const; //by value, packed elements don't have a stored NodeData
+                std::string_view StringView() const;
+                void FieldError(const char* what) const;
+
+                const GonFrozen* doc;
+                uint32_t index;   //NullIndex for missing fields, the array for packed elements
+                uint32_t element; //position in a packed array, NullIndex otherwise
+        };
+
+        GonFrozen();
+        explicit GonFrozen(const GonObject& tree);
+
+        static GonFrozen Freeze(const GonObject& tree);
+
+        Node Root() const;
+        Node operator[](std::string_view child) const; //shorthand for Root()[child]
+
+        Key Intern(std::string_view key) const;
+
+        size_t NodeCount() const;
+        size_t MemoryUsage() const; //bytes held by the node table, string pool, hash tables, key index and packed arrays
+
+    private:
+        friend class Node;
+
+        uint32_t FindChild(const NodeData& obj, std::string_view key) const;
+        uint32_t FindChild(const NodeData& obj, const Key& key) const;
+        std::string_view PoolString(uint32_t offset, uint32_t length) const;
+
+        std::vector<NodeData> nodes;
+        std::string pool;
+        std::vector<uint32_t> seeds;
+        std::vector<uint32_t> slots;
+        std::vector<uint32_t> names; //pool offsets of every distinct field name, sorted by name (for Intern)
+
+        std::vector<int64_t> packed_ints;
+        std::vector<double> packed_doubles;
+        std::vector<uint32_t> packed_text;
+        std::vector<bool> packed_bools;
+        uint32_t bool_text[2]; //pool offsets of "false" and "true"
+};
@@ -0,0 +1,134 @@
+//Glaiel Object Notation
+//gon_number_test: checks that numbers keep their exact value through Save and Load, and .add/.multiply near the int64 limits
+//
+//build:
+//    g++ -O2 -std=c++17 gon_number_test.cpp gon.cpp -o gon_number_test
+//usage:
+//    gon_number_test [scratch file, default gon_number_test.gon]
+//prints every failed check and exits with 1 if there were any
+
+#include "gon.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static int failures = 0;
+
+static bool SameDouble(double a, double b){
+    return std::memcmp(&a, &b, sizeof(double)) == 0; //tells -0.0 from 0.0
+}
+
+//the value a number field should hold, and the text it was made from (for messages)
+struct GonNumberCase {
+    const char* name;
+    int64_t int_value;
+    double float_value;
+};
+
+static void Check(const GonNumberCase& expected, const GonObject& obj, const char* stage){
+    if(obj.type != GonObject::FieldType::NUMBER || obj.int_data != expected.int_value || !SameDouble(obj.float_data, expected.float_value)){
+        printf("FAIL %s (%s): expected int %" PRId64 " float %.17g, got type %d int %" PRId64 " float %.17g\n",
+            expected.name, stage, expected.int_value, expected.float_value, (int)obj.type, obj.int_data, obj.float_data);
+        failures++;
+    }
+}
+
+//saves root to a file, loads it back and checks every case against its reloaded field
+//the saved text must also be the same after a second round
+static void CheckRoundTrip(const GonObject& root, const GonNumberCase* cases, int count, const std::string& scratch){
+    std::string first = root.SaveToStr();
+    root.Save(scratch);
+    GonObject loaded = GonObject::Load(scratch)[""]; //Save writes the root as a field named ""
+    for(int i = 0; i<count; i++){
+        Check(cases[i], loaded[cases[i].name], "after save and load");
+    }
+    std::string second = loaded.SaveToStr();
+    if(second != first){
+        printf("FAIL saved text changed after a round trip:\n%s\nvs\n%s\n", first.c_str(), second.c_str());
+        failures++;
+    }
+}
+
+static void TestLiterals(const std::string& scratch){
+    const GonNumberCase cases[] = {
+        {"max", INT64_MAX, 9223372036854775807.0},
+        {"min", INT64_MIN, -9223372036854775808.0},
+        {"two_pow_63", INT64_MAX, 9223372036854775808.0}, //int_data saturates
+        {"below_min", INT64_MIN, -9223372036854775809.0},
+        {"tenth", 0, 0.1},
+        {"huge", INT64_MAX, 1e300},
+        {"denormal", 0, 5e-324},
+        {"hex", 31, 31.0},
+        {"hex_max", INT64_MAX, 9223372036854775807.0},
+        {"negative_hex", -16, -16.0},
+        {"negative_zero", 0, -0.0},
+        {"negative_zero_int", 0, -0.0},
+    };
+    const char* text =
+        "max 9223372036854775807 min -9223372036854775808 two_pow_63 9223372036854775808 below_min -9223372036854775809 "
+        "tenth 0.1 huge 1e300 denormal 5e-324 hex 0x1F hex_max 0x7FFFFFFFFFFFFFFF negative_hex -0x10 "
+        "negative_zero -0.0 negative_zero_int -0";
+    const int count = sizeof(cases)/sizeof(cases[0]);
+
+    GonObject root = GonObject::LoadFromBuffer(text);
+    for(int i = 0; i<count; i++){
+        Check(cases[i], root[cases[i].name], "after load");
+    }
+    CheckRoundTrip(root, cases, count, scratch);
+}
+
+//each case is "name base" in the base document and "name.add operand" or "name.multiply operand" in the patch
+static void TestArithmetic(const std::string& scratch){
+    const GonNumberCase cases[] = {
+        {"max_plus_one", INT64_MAX, 9223372036854775807.0 + 1.0},
+        {"max_minus_one", INT64_MAX - 1, (double)(INT64_MAX - 1)},
+        {"min_minus_one", INT64_MIN, -9223372036854775808.0 - 1.0},
+        {"min_plus_one", INT64_MIN + 1, (double)(INT64_MIN + 1)},
+        {"past_double_precision", 9007199254740995, 9007199254740995.0},
+        {"max_times_two", INT64_MAX, 9223372036854775807.0 * 2.0},
+        {"min_times_minus_one", INT64_MAX, 9223372036854775808.0},
+        {"square_overflow", INT64_MAX, 3037000500.0 * 3037000500.0},
+        {"square_fits", 9223372030926249001, (double)9223372030926249001},
+        {"times_two_to_min", INT64_MIN, -9223372036854775808.0},
+        {"half_of_max", 4611686018427387904, 0.5 * 9223372036854775807.0},
+    };
+    const char* base =
+        "max_plus_one 9223372036854775807 max_minus_one 9223372036854775807 min_minus_one -9223372036854775808 "
+        "min_plus_one -9223372036854775808 past_double_precision 9007199254740993 max_times_two 9223372036854775807 "
+        "min_times_minus_one -9223372036854775808 square_overflow 3037000500 square_fits 3037000499 "
+        "times_two_to_min -4611686018427387904 half_of_max 0.5";
+    const char* patch =
+        "max_plus_one.add 1 max_minus_one.add -1 min_minus_one.add -1 min_plus_one.add 1 past_double_precision.add 2 "
+        "max_times_two.multiply 2 min_times_minus_one.multiply -1 square_overflow.multiply 3037000500 "
+        "square_fits.multiply 3037000499 times_two_to_min.multiply 2 half_of_max.multiply 9223372036854775807";
+    const int count = sizeof(cases)/sizeof(cases[0]);
+
+    GonObject root = GonObject::LoadFromBuffer(base);
+    root.PatchMerge(GonObject::LoadFromBuffer(patch));
+    for(int i = 0; i<count; i++){
+        Check(cases[i], root[cases[i].name], "after merge");
+    }
+    CheckRoundTrip(root, cases, count, scratch);
+}
+
+int main(int argc, char** argv){
+    std::string scratch = argc > 1 ? argv[1] : "gon_number_test.gon";
+    try {
+        TestLiterals(scratch);
+        TestArithmetic(scratch);
+    } catch(const std::string& error){
+        printf("FAIL %s\n", error.c_str());
+        failures++;
+    }
+    std::remove(scratch.c_str());
+
+    if(failures){
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
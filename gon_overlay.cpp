@@ -0,0 +1,389 @@
+#include "gon_overlay.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+//objects without duplicate field names (the common case) are answered straight from children_map
+static bool HasDuplicateNames(const GonObject& obj){
+    return obj.children_map.size() != obj.children_array.size();
+}
+
+struct GonOverlay::MergePlan {
+    std::vector<std::vector<const GonObject*>> fields; //each field of the merged object: the field it starts as, then every field merged into it
+    std::vector<int> field_of;    //the merged field each child of each layer belongs to, layer after layer
+    std::vector<int> layer_start; //where each layer's children start in field_of
+};
+
+//without duplicate names every field merges into the one with its name below it, and so do children of arrays and other values
+bool GonOverlay::HasDuplicates() const {
+    if(layer_count <= 1 || Type() != GonObject::FieldType::OBJECT) return false;
+
+    const GonObject* const* layers = Layers();
+    for(int i = 0; i<layer_count; i++){
+        if(HasDuplicateNames(*layers[i])) return true;
+    }
+    return false;
+}
+
+//replays how DeepMerge pairs up fields, looking only at the names: a layer's first field with a name merges into the last merged field
+//with that name (the one operator[] finds), its nth one (n > 0) into the nth counting from the first, and a field with no match is appended
+//(and can be merged into by the fields after it, even from the same layer). the bottom layer is copied, so its fields are all kept
+std::shared_ptr<const GonOverlay::MergePlan> GonOverlay::BuildPlan() const {
+    std::shared_ptr<MergePlan> plan = std::make_shared<MergePlan>();
+    std::unordered_map<std::string_view, std::vector<int>> by_name; //merged fields with each name, in order
+
+    const GonObject* const* layers = Layers();
+    for(int i = 0; i<layer_count; i++){
+        plan->layer_start.push_back((int)plan->field_of.size());
+        std::unordered_map<std::string_view, int> counts;
+        for(const GonObject& child : layers[i]->children_array){
+            std::vector<int>& same = by_name[child.name];
+            int target = -1;
+            if(i > 0){
+                int& count = counts[child.name];
+                if(count == 0 && !same.empty()) target = same.back();
+                else if(count > 0 && count < (int)same.size()) target = same[count];
+                if(target != -1) count++;
+            }
+            if(target == -1){
+                target = (int)plan->fields.size();
+                plan->fields.emplace_back();
+                same.push_back(target);
+            }
+            plan->fields[target].push_back(&child);
+            plan->field_of.push_back(target);
+        }
+    }
+    return plan;
+}
+
+//the nth merged field named name counting from the first, or the last one for -1
+const std::vector<const GonObject*>* GonOverlay::FindMerged(const MergePlan& plan, std::string_view name, int nth){
+    const std::vector<const GonObject*>* last = nullptr;
+    for(const std::vector<const GonObject*>& field : plan.fields){
+        if(field.front()->name != name) continue;
+        if(nth == -1) last = &field;
+        else if(nth-- == 0) return &field;
+    }
+    return last;
+}
+
+GonOverlay GonOverlay::Merged(const std::vector<const GonObject*>* field){
+    GonOverlay res;
+    if(field){
+        for(const GonObject* layer : *field) res.AddLayer(layer);
+    }
+    return res;
+}
+
+
+GonOverlay::Iterator::Iterator(const GonOverlay* overlay, int layer, int index):overlay(overlay),layer(layer),index(index){
+    SkipMerged();
+}
+GonOverlay GonOverlay::Iterator::operator*() const {
+    if(overlay->Type() == GonObject::FieldType::OBJECT || overlay->Type() == GonObject::FieldType::ARRAY) return overlay->Child(layer, index, plan.get());
+    return *overlay;
+}
+GonOverlay::Iterator& GonOverlay::Iterator::operator++(){
+    index++;
+    SkipMerged();
+    return *this;
+}
+bool GonOverlay::Iterator::operator==(const Iterator& other) const {
+    return overlay == other.overlay && layer == other.layer && index == other.index;
+}
+bool GonOverlay::Iterator::operator!=(const Iterator& other) const {
+    return !(*this == other);
+}
+
+//moves to the next field that isn't merged into one from a lower layer (objects only)
+void GonOverlay::Iterator::SkipMerged(){
+    if(overlay->Type() != GonObject::FieldType::OBJECT) return;
+
+    const GonObject* const* layers = overlay->Layers();
+    if(!plan && layer < overlay->layer_count && overlay->HasDuplicates()) plan = overlay->BuildPlan();
+
+    while(layer < overlay->layer_count){
+        const GonObject& obj = *layers[layer];
+        if(index >= (int)obj.children_array.size()){
+            layer++;
+            index = 0;
+            continue;
+        }
+
+        const GonObject& field = obj.children_array[index];
+        bool merged = false;
+        if(plan){
+            merged = plan->fields[plan->field_of[plan->layer_start[layer]+index]].front() != &field;
+        } else {
+            for(int below = 0; below<layer && !merged; below++){
+                merged = layers[below]->Contains(field.name);
+            }
+        }
+        if(!merged) return;
+        index++;
+    }
+}
+
+
+GonOverlay::GonOverlay():inline_layers{},layer_count(0){
+}
+GonOverlay::GonOverlay(std::initializer_list<const GonObject*> layers):inline_layers{},layer_count(0){
+    for(const GonObject* layer : layers) AddLayer(layer);
+}
+GonOverlay::GonOverlay(const std::vector<const GonObject*>& layers):inline_layers{},layer_count(0){
+    for(const GonObject* layer : layers) AddLayer(layer);
+}
+
+void GonOverlay::Push(const GonObject& layer){
+    AddLayer(&layer);
+}
+
+const GonObject* const* GonOverlay::Layers() const {
+    return layer_count <= InlineLayers ? inline_layers : more_layers.data();
+}
+const GonObject& GonOverlay::Top() const {
+    if(layer_count == 0) return GonObject::null_gon;
+    return *Layers()[layer_count-1];
+}
+
+void GonOverlay::AddLayer(const GonObject* layer){
+    if(layer->type == GonObject::FieldType::NULLGON) return;
+
+    //only an object on an object or an array on an array merges, anything else replaces what's below it
+    bool container = layer->type == GonObject::FieldType::OBJECT || layer->type == GonObject::FieldType::ARRAY;
+    if(layer_count > 0 && (!container || layer->type != Top().type)){
+        layer_count = 0;
+        more_layers.clear();
+    }
+
+    if(layer_count < InlineLayers){
+        inline_layers[layer_count] = layer;
+    } else {
+        if(layer_count == InlineLayers) more_layers.assign(inline_layers, inline_layers + InlineLayers);
+        more_layers.push_back(layer);
+    }
+    layer_count++;
+}
+
+GonOverlay GonOverlay::Child(int layer, int index, const MergePlan* plan) const {
+    const GonObject* const* layers = Layers();
+    GonOverlay res;
+
+    if(Type() == GonObject::FieldType::ARRAY){
+        for(int i = 0; i<layer_count; i++){
+            if(index < (int)layers[i]->children_array.size()) res.AddLayer(&layers[i]->children_array[index]);
+        }
+        return res;
+    }
+
+    if(plan) return Merged(&plan->fields[plan->field_of[plan->layer_start[layer]+index]]);
+
+    //the layers below this one don't have the field (see Iterator::SkipMerged)
+    const GonObject& field = layers[layer]->children_array[index];
+    res.AddLayer(&field);
+    for(int i = layer+1; i<layer_count; i++){
+        const GonObject& found = (*layers[i])[field.name];
+        if(found.Exists()) res.AddLayer(&found);
+    }
+    return res;
+}
+
+
+std::string GonOverlay::String() const {
+    return Top().String();
+}
+const char* GonOverlay::CString() const {
+    return Top().CString();
+}
+int GonOverlay::Int() const {
+    return Top().Int();
+}
+int64_t GonOverlay::Int64() const {
+    return Top().Int64();
+}
+double GonOverlay::Number() const {
+    return Top().Number();
+}
+double GonOverlay::Percent() const {
+    return Top().Percent();
+}
+bool GonOverlay::Bool() const {
+    return Top().Bool();
+}
+
+std::string GonOverlay::String(const std::string& _default) const {
+    return Top().String(_default);
+}
+const char* GonOverlay::CString(const char* _default) const {
+    return Top().CString(_default);
+}
+int GonOverlay::Int(int _default) const {
+    return Top().Int(_default);
+}
+int64_t GonOverlay::Int64(int64_t _default) const {
+    return Top().Int64(_default);
+}
+double GonOverlay::Number(double _default) const {
+    return Top().Number(_default);
+}
+double GonOverlay::Percent(double _default) const {
+    return Top().Percent(_default);
+}
+bool GonOverlay::Bool(bool _default) const {
+    return Top().Bool(_default);
+}
+
+bool GonOverlay::Contains(std::string_view child) const {
+    if(Type() != GonObject::FieldType::OBJECT) return false;
+
+    const GonObject* const* layers = Layers();
+    for(int i = 0; i<layer_count; i++){
+        if(layers[i]->Contains(child)) return true;
+    }
+    return false;
+}
+bool GonOverlay::ContainsNthChildWithName(std::string_view child, int index) const {
+    if(Type() != GonObject::FieldType::OBJECT) return false;
+
+    if(index == 0) return Contains(child);
+    if(layer_count == 1) return Layers()[0]->ContainsNthChildWithName(child, index);
+    if(!HasDuplicates()) return false; //at most one field per name
+
+    return FindMerged(*BuildPlan(), child, index) != nullptr;
+}
+bool GonOverlay::Contains(int child) const {
+    if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return true;
+
+    return child >= 0 && child < Size();
+}
+bool GonOverlay::Exists() const {
+    return layer_count > 0;
+}
+bool GonOverlay::IsPercent() const {
+    return Top().IsPercent();
+}
+
+GonOverlay GonOverlay::operator[](std::string_view child) const {
+    GonObject::last_accessed_named_field = child;
+
+    GonOverlay res;
+    if(Type() != GonObject::FieldType::OBJECT) return res;
+
+    //operator[] finds the last field with the name
+    if(HasDuplicates()) return Merged(FindMerged(*BuildPlan(), child, -1));
+
+    const GonObject* const* layers = Layers();
+    for(int i = 0; i<layer_count; i++){
+        res.AddLayer(&(*layers[i])[child]);
+    }
+    return res;
+}
+GonOverlay GonOverlay::ChildOrSelf(std::string_view child) const {
+    if(Contains(child)) return (*this)[child];
+    return *this;
+}
+GonOverlay GonOverlay::NthChildWithName(std::string_view child, int index) const {
+    GonObject::last_accessed_named_field = child;
+
+    if(Type() != GonObject::FieldType::OBJECT) return GonOverlay();
+
+    if(index == 0) return (*this)[child];
+    if(HasDuplicates()) return Merged(FindMerged(*BuildPlan(), child, index));
+
+    //without duplicates there's at most one field per name, or one per layer if there's only one
+    if(layer_count == 1) return GonOverlay{&Layers()[0]->NthChildWithName(child, index)};
+    return GonOverlay();
+}
+GonOverlay GonOverlay::FieldInChildOrSelf(std::string_view child, std::string_view field) const {
+    GonOverlay res = (*this)[child][field];
+    if(res.Exists()) return res;
+    return (*this)[field];
+}
+GonOverlay GonOverlay::operator[](int childindex) const {
+    if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return *this;
+    if(childindex < 0) return GonOverlay();
+
+    if(Type() == GonObject::FieldType::ARRAY){
+        if(childindex >= Size()) return GonOverlay();
+        return Child(0, childindex, nullptr);
+    }
+    if(HasDuplicates()){
+        std::shared_ptr<const MergePlan> plan = BuildPlan();
+        if(childindex >= (int)plan->fields.size()) return GonOverlay();
+        return Merged(&plan->fields[childindex]); //in the order DeepMerge leaves them in
+    }
+
+    //the bottom layer's fields come first and nothing is merged into them from below, the rest have to be counted
+    int bottom = (int)Layers()[0]->children_array.size();
+    if(childindex < bottom) return Child(0, childindex, nullptr);
+
+    childindex -= bottom;
+    for(Iterator iter(this, 1, 0); iter != end(); ++iter, childindex--){
+        if(childindex == 0) return *iter;
+    }
+    return GonOverlay();
+}
+
+int GonOverlay::Size() const {
+    return size();
+}
+int GonOverlay::size() const {
+    if(layer_count == 0) return 0;
+    if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return 1;
+
+    const GonObject* const* layers = Layers();
+    if(Type() == GonObject::FieldType::ARRAY){
+        int res = 0;
+        for(int i = 0; i<layer_count; i++){
+            res = std::max(res, (int)layers[i]->children_array.size());
+        }
+        return res;
+    }
+
+    if(layer_count == 1) return (int)layers[0]->children_array.size();
+    if(HasDuplicates()) return (int)BuildPlan()->fields.size();
+    int res = (int)layers[0]->children_array.size();
+    for(Iterator iter(this, 1, 0); iter != end(); ++iter) res++;
+    return res;
+}
+bool GonOverlay::empty() const {
+    return size() == 0;
+}
+GonOverlay::Iterator GonOverlay::begin() const {
+    if(layer_count == 0) return end();
+    return Iterator(this, 0, 0);
+}
+GonOverlay::Iterator GonOverlay::end() const {
+    if(Type() == GonObject::FieldType::OBJECT) return Iterator(this, layer_count, 0);
+    return Iterator(this, 0, size());
+}
+
+std::string_view GonOverlay::Name() const {
+    if(layer_count == 0) return std::string_view();
+    return Layers()[0]->name; //merging keeps the name of what's merged into
+}
+GonObject::FieldType GonOverlay::Type() const {
+    return Top().type;
+}
+
+int GonOverlay::LayerCount() const {
+    return layer_count;
+}
+const GonObject& GonOverlay::Layer(int layer) const {
+    return *Layers()[layer];
+}
+
+GonObject GonOverlay::Flatten(std::pmr::memory_resource* resource) const {
+    GonObject::allocator_type alloc(resource);
+    if(layer_count <= 1) return GonObject(Top(), alloc);
+
+    GonObject res(alloc);
+    res.type = Type();
+    res.name = Name();
+    for(GonOverlay child : *this){
+        res.children_array.push_back(child.Flatten(resource));
+        if(res.type == GonObject::FieldType::OBJECT) res.children_map[res.children_array.back().name] = (int)res.children_array.size() - 1;
+    }
+    return res;
+}
@@ -0,0 +1,122 @@
+//Glaiel Object Notation
+//lazy layered views over stacks of objects
+
+#pragma once
+#include "gon.h"
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//reads a stack of objects as if each layer had been DeepMerged (with the default MERGE policy) onto the ones below it,
+//without copying anything: lookups go through the layers and only the values read are resolved
+//
+//    GonObject base = GonObject::Load("units.gon");
+//    GonObject player = GonObject::Load("player_overrides.gon");
+//    GonOverlay units = {&base, &player};
+//    int hp = units["archer"]["hp"].Int();
+//
+//same as DeepMerge: objects are merged field by field, arrays element by element, and any other value (or a value of a
+//different type) replaces what's below it. fields with duplicate names pair up the way DeepMerge pairs them, so a layer's first field
+//with a name overrides the last one below it (the one operator[] finds). objects with duplicate names in any layer are slower to read,
+//each lookup or iteration replays the pairing over their fields
+//nothing is cached between calls: size() and operator[](int) past the bottom layer's fields walk the fields of every layer above it,
+//so a for(i<Size()) ov[i] loop over a big layered object is quadratic. loop with begin()/end(), or Flatten it once, instead
+//null layers are skipped instead of replacing everything below them
+//
+//mirrors the read side of GonObject's API and is returned by value (it's just the list of layers that contribute to one node)
+//the layers must outlive the overlay and every overlay taken from it, and not be modified while they're in use
+class GonOverlay {
+    private:
+        struct MergePlan;
+
+    public:
+        class Iterator {
+            public:
+                Iterator(const GonOverlay* overlay, int layer, int index);
+                GonOverlay operator*() const;
+                Iterator& operator++();
+                bool operator==(const Iterator& other) const;
+                bool operator!=(const Iterator& other) const;
+
+            private:
+                void SkipMerged();
+
+                const GonOverlay* overlay;
+                int layer; //objects: children of layers[layer] that aren't merged into a field below them, arrays and other values: unused
+                int index;
+                std::shared_ptr<const MergePlan> plan; //objects with duplicate names only
+        };
+
+        GonOverlay();
+        GonOverlay(std::initializer_list<const GonObject*> layers); //bottom layer first
+        explicit GonOverlay(const std::vector<const GonObject*>& layers);
+
+        //adds a layer on top
+        void Push(const GonObject& layer);
+
+        //same behavior as the GonObject functions with the same names
+        std::string String() const;
+        const char* CString() const;
+        int Int() const;
+        int64_t Int64() const;
+        double Number() const;
+        double Percent() const;
+        bool Bool() const;
+
+        std::string String(const std::string& _default) const;
+        const char* CString(const char* _default) const;
+        int Int(int _default) const;
+        int64_t Int64(int64_t _default) const;
+        double Number(double _default) const;
+        double Percent(double _default) const;
+        bool Bool(bool _default) const;
+
+        bool Contains(std::string_view child) const;
+        bool ContainsNthChildWithName(std::string_view child, int index) const;
+        bool Contains(int child) const;
+        bool Exists() const;
+        bool IsPercent() const;
+
+        GonOverlay operator[](std::string_view child) const;
+        GonOverlay ChildOrSelf(std::string_view child) const;
+        GonOverlay NthChildWithName(std::string_view child, int index) const;
+        GonOverlay FieldInChildOrSelf(std::string_view child, std::string_view field) const;
+        GonOverlay operator[](int childindex) const;
+
+        //objects: every field of the bottom layer, then the fields each layer above adds, in layer order (the order DeepMerge leaves them in)
+        int Size() const;
+        int size() const;
+        bool empty() const;
+        Iterator begin() const;
+        Iterator end() const;
+
+        std::string_view Name() const;
+        GonObject::FieldType Type() const;
+
+        //the layers that make up this node, bottom first: one for values that aren't objects or arrays, none if it doesn't exist
+        int LayerCount() const;
+        const GonObject& Layer(int layer) const;
+
+        //copies the merged subtree into a regular GonObject, the same as copying the bottom layer and DeepMerging the others onto it
+        GonObject Flatten(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+    private:
+        static constexpr int InlineLayers = 4;
+
+        const GonObject* const* Layers() const;
+        const GonObject& Top() const; //null_gon if there are no layers
+        void AddLayer(const GonObject* layer);
+        GonOverlay Child(int layer, int index, const MergePlan* plan) const; //the merged field for the child at index of layers[layer]
+
+        bool HasDuplicates() const; //an object of more than one layer where some layer has duplicate names
+        std::shared_ptr<const MergePlan> BuildPlan() const;
+        static const std::vector<const GonObject*>* FindMerged(const MergePlan& plan, std::string_view name, int nth);
+        static GonOverlay Merged(const std::vector<const GonObject*>* field);
+
+        const GonObject* inline_layers[InlineLayers];
+        std::vector<const GonObject*> more_layers; //every layer once there are more than InlineLayers
+        int layer_count;
+};
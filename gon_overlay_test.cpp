@@ -0,0 +1,143 @@
+//Glaiel Object Notation
+//gon_overlay_test: checks GonOverlay against copying the bottom layer and DeepMerging the others onto it, on random stacks of layers
+//
+//build:
+//    g++ -O2 -std=c++17 gon_overlay_test.cpp gon_overlay.cpp gon.cpp -o gon_overlay_test
+//usage:
+//    gon_overlay_test [stacks, default 20000]
+//every other stack uses only a few field names so that objects have duplicates, the rest have none
+//compares the whole merged tree (through iteration and through Flatten), Size, operator[](int) on the root, and operator[],
+//Contains, NthChildWithName and ContainsNthChildWithName for every name. prints the first few mismatches, exits with 1 if there were any
+
+#include "gon_overlay.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::mt19937 random_engine(7);
+static const char* names[] = {"a", "b", "c", "d", "e", "f", "g", "h"};
+static const int name_count = sizeof(names)/sizeof(names[0]);
+
+static int Random(int count){
+    return (int)(random_engine() % (unsigned)count);
+}
+
+static GonObject RandomValue(int depth, bool duplicates){
+    GonObject res;
+    switch(depth >= 3 ? 2 + Random(3) : Random(5)){
+        case 0:
+            res.type = GonObject::FieldType::OBJECT;
+            for(int i = Random(5); i > 0; i--){
+                const char* name = names[Random(duplicates ? 3 : name_count)];
+                if(!duplicates && res.Contains(name)) continue;
+                res.InsertChild(name, RandomValue(depth+1, duplicates));
+            }
+            break;
+        case 1:
+            res.type = GonObject::FieldType::ARRAY;
+            for(int i = Random(4); i > 0; i--){
+                res.InsertChild(RandomValue(depth+1, duplicates));
+            }
+            break;
+        case 2: res = GonObject::LoadFromBuffer("x " + std::to_string(Random(100)))["x"]; break;
+        case 3: res = GonObject::LoadFromBuffer("x s" + std::to_string(Random(100)))["x"]; break;
+        default: res = GonObject::LoadFromBuffer(Random(2) ? "x true" : "x false")["x"]; break;
+    }
+    return res;
+}
+
+//the whole subtree as text, read only through the overlay API (names, types, iteration, String)
+static std::string Dump(const GonOverlay& obj){
+    std::string res;
+    switch(obj.Type()){
+        case GonObject::FieldType::OBJECT:
+            res += "{";
+            for(GonOverlay child : obj) res += std::string(child.Name()) + ":" + Dump(child) + " ";
+            res += "}";
+            break;
+        case GonObject::FieldType::ARRAY:
+            res += "[";
+            for(GonOverlay child : obj) res += Dump(child) + " ";
+            res += "]";
+            break;
+        case GonObject::FieldType::NULLGON: res += "null"; break;
+        default: res += obj.String(); break;
+    }
+    return res;
+}
+static std::string Dump(const GonObject& obj){
+    return Dump(GonOverlay{&obj});
+}
+
+static int failures = 0;
+
+static void Fail(const std::vector<GonObject>& layers, const std::string& what){
+    if(failures++ >= 3) return;
+    printf("FAIL %s\n", what.c_str());
+    for(const GonObject& layer : layers) printf("    layer %s\n", layer.SaveToStr(true).c_str());
+}
+
+static bool Same(const GonOverlay& overlay, const GonObject& merged){
+    return overlay.Exists() == merged.Exists() && (!merged.Exists() || Dump(overlay) == Dump(merged));
+}
+
+static void CheckStack(bool duplicates){
+    std::vector<GonObject> layers;
+    for(int i = 1 + Random(6); i > 0; i--){
+        GonObject layer = RandomValue(0, duplicates);
+        if(layer.type != GonObject::FieldType::OBJECT){
+            GonObject wrapper;
+            wrapper.type = GonObject::FieldType::OBJECT;
+            wrapper.InsertChild(names[Random(name_count)], layer);
+            layer = wrapper;
+        }
+        layers.push_back(layer);
+    }
+
+    GonObject merged = layers[0];
+    for(size_t i = 1; i<layers.size(); i++) merged.DeepMerge(layers[i]);
+
+    std::vector<const GonObject*> pointers;
+    for(const GonObject& layer : layers) pointers.push_back(&layer);
+    GonOverlay overlay(pointers);
+
+    if(overlay.Flatten().SaveToStr(true) != merged.SaveToStr(true)) Fail(layers, "Flatten: " + overlay.Flatten().SaveToStr(true) + " vs " + merged.SaveToStr(true));
+    if(Dump(overlay) != Dump(merged)) Fail(layers, "iteration: " + Dump(overlay) + " vs " + Dump(merged));
+    if(overlay.Size() != merged.Size()) Fail(layers, "Size: " + std::to_string(overlay.Size()) + " vs " + std::to_string(merged.Size()));
+    for(int i = 0; i<=merged.Size(); i++){
+        if(!Same(overlay[i], merged[i])) Fail(layers, "operator[](" + std::to_string(i) + ")");
+    }
+
+    for(const char* name : names){
+        if(!Same(overlay[name], merged[name]) || overlay.Contains(name) != merged.Contains(name)) Fail(layers, std::string("operator[](") + name + ")");
+        for(int nth = 1; nth<4; nth++){
+            if(overlay.ContainsNthChildWithName(name, nth) != merged.ContainsNthChildWithName(name, nth) || !Same(overlay.NthChildWithName(name, nth), merged.NthChildWithName(name, nth))){
+                Fail(layers, std::string("NthChildWithName(") + name + ", " + std::to_string(nth) + ")");
+            }
+        }
+        for(int i = 0; i<4; i++){
+            if(!Same(overlay[name][i], merged[name][i])) Fail(layers, std::string("[") + name + "][" + std::to_string(i) + "]");
+        }
+    }
+}
+
+int main(int argc, char** argv){
+    int stacks = argc > 1 ? std::max(1, atoi(argv[1])) : 20000;
+    try {
+        for(int i = 0; i<stacks; i++) CheckStack(i % 2 == 1);
+    } catch(const std::string& error){
+        printf("FAIL %s\n", error.c_str());
+        failures++;
+    }
+
+    if(failures){
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("all %d stacks matched\n", stacks);
+    return 0;
+}
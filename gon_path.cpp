@@ -0,0 +1,233 @@
+#include "gon_path.h"
+
+#include <cstdlib>
+
+static bool IsPathSymbol(char c){
+    return c=='.'||c=='['||c==']'||c=='@'||c=='?'||c=='"';
+}
+
+GonPath::GonPath():valid(true){
+}
+
+GonPath::GonPath(std::string_view path):text(path),valid(true){
+    size_t i = 0;
+    bool error = false;
+
+    while(i < path.size() && !error){
+        Segment segment;
+        segment.index = 0;
+        segment.is_index = false;
+        segment.optional = false;
+
+        if(path[i] == '?'){
+            segment.optional = true;
+            i++;
+        }
+
+        if(i < path.size() && path[i] == '['){
+            size_t end = path.find(']', i);
+            if(end == std::string_view::npos || end == i+1){
+                error = true;
+                break;
+            }
+            std::string digits(path.substr(i+1, end-i-1));
+            char* endptr;
+            segment.index = (int)strtol(digits.c_str(), &endptr, 10);
+            if(*endptr != 0) error = true;
+            segment.is_index = true;
+            i = end+1;
+        } else if(i < path.size() && path[i] == '"'){
+            i++;
+            bool escaped = false;
+            for(; i < path.size(); i++){
+                if(escaped){
+                    segment.name += path[i];
+                    escaped = false;
+                } else if(path[i] == '\\'){
+                    escaped = true;
+                } else if(path[i] == '"'){
+                    break;
+                } else {
+                    segment.name += path[i];
+                }
+            }
+            if(i >= path.size()) error = true;
+            i++;
+        } else {
+            size_t start = i;
+            while(i < path.size() && !IsPathSymbol(path[i])) i++;
+            if(i == start) error = true;
+            segment.name = path.substr(start, i-start);
+        }
+
+        if(!segment.is_index && i < path.size() && path[i] == '@'){
+            size_t start = ++i;
+            while(i < path.size() && path[i] >= '0' && path[i] <= '9') i++;
+            if(i == start) error = true;
+            else segment.index = atoi(std::string(path.substr(start, i-start)).c_str());
+        }
+
+        segments.push_back(std::move(segment));
+
+        //segments are separated by a '.', which is optional before a '['
+        if(i < path.size()){
+            if(path[i] == '.' && i+1 < path.size()) i++;
+            else if(path[i] != '[') error = true;
+        }
+    }
+
+    if(error){
+        segments.clear();
+        valid = false;
+        GonObject::ErrorCallback("GON ERROR: malformed path \""+text+"\"");
+    }
+}
+
+const GonObject* GonPath::Step(const GonObject& obj, const Segment& segment){
+    if(segment.is_index){
+        if(obj.type == GonObject::FieldType::NULLGON) return nullptr;
+        if(obj.type != GonObject::FieldType::OBJECT && obj.type != GonObject::FieldType::ARRAY) return &obj; //same as operator[](int)
+        if(segment.index < 0 || segment.index >= (int)obj.children_array.size()) return nullptr;
+        return &obj.children_array[segment.index];
+    }
+
+    if(obj.type != GonObject::FieldType::OBJECT) return nullptr;
+
+    if(segment.index == 0){
+        auto iter = obj.children_map.find(segment.name);
+        if(iter == obj.children_map.end()) return nullptr;
+        return &obj.children_array[iter->second];
+    }
+
+    int index = segment.index;
+    for(auto& entry : obj.children_array){
+        if(entry.name == segment.name){
+            if(index-- == 0) return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const GonObject* GonPath::EvaluateFrom(const GonObject& obj, size_t first) const {
+    if(!valid) return nullptr;
+
+    const GonObject* current = &obj;
+    for(size_t i = first; i<segments.size(); i++){
+        const Segment& segment = segments[i];
+        if(segment.optional){
+            const GonObject* child = Step(*current, segment);
+            if(child){
+                const GonObject* res = EvaluateFrom(*child, i+1);
+                if(res && res->Exists()) return res;
+            }
+            continue; //fall back to evaluating the rest of the path from current
+        }
+
+        current = Step(*current, segment);
+        if(!current) return nullptr;
+    }
+    return current;
+}
+
+const GonObject& GonPath::Evaluate(const GonObject& root) const {
+    const GonObject* res = EvaluateFrom(root, 0);
+    if(res) return *res;
+
+    GonObject::last_accessed_named_field = text;
+    return GonObject::null_gon;
+}
+GonObject& GonPath::Evaluate(GonObject& root) const {
+    const GonObject* res = EvaluateFrom(root, 0);
+    if(res) return const_cast<GonObject&>(*res);
+
+    GonObject::last_accessed_named_field = text;
+    return GonObject::non_const_null_gon;
+}
+const GonObject& GonPath::operator()(const GonObject& root) const {
+    return Evaluate(root);
+}
+GonObject& GonPath::operator()(GonObject& root) const {
+    return Evaluate(root);
+}
+
+const std::string& GonPath::ToString() const {
+    return text;
+}
+const std::vector<GonPath::Segment>& GonPath::Segments() const {
+    return segments;
+}
+bool GonPath::Valid() const {
+    return valid;
+}
+
+
+GonPathBatch::GonPathBatch(){
+    Node root;
+    root.path = -1;
+    root.segment = 0;
+    nodes.push_back(root);
+}
+
+int GonPathBatch::Add(std::string_view path){
+    return Add(GonPath(path));
+}
+
+int GonPathBatch::Add(const GonPath& path){
+    int path_index = (int)paths.size();
+    paths.push_back(path);
+    if(!path.Valid()) return path_index; //stays null_gon
+
+    const std::vector<GonPath::Segment>& segments = paths.back().Segments();
+    int node = 0;
+    for(size_t i = 0; i<segments.size(); i++){
+        const GonPath::Segment& segment = segments[i];
+        if(segment.optional){
+            nodes[node].tails.push_back(std::make_pair(path_index, i));
+            return path_index;
+        }
+
+        int next = -1;
+        for(int child : nodes[node].children){
+            const GonPath::Segment& other = paths[nodes[child].path].Segments()[nodes[child].segment];
+            if(other.is_index == segment.is_index && other.index == segment.index && other.name == segment.name){
+                next = child;
+                break;
+            }
+        }
+        if(next == -1){
+            Node created;
+            created.path = path_index;
+            created.segment = i;
+            next = (int)nodes.size();
+            nodes.push_back(created);
+            nodes[node].children.push_back(next);
+        }
+        node = next;
+    }
+    nodes[node].finished_paths.push_back(path_index);
+    return path_index;
+}
+
+int GonPathBatch::Size() const {
+    return (int)paths.size();
+}
+
+void GonPathBatch::EvaluateNode(int node, const GonObject* obj, std::vector<const GonObject*>& results) const {
+    const Node& n = nodes[node];
+    for(int path : n.finished_paths){
+        results[path] = obj;
+    }
+    for(auto& tail : n.tails){
+        const GonObject* res = paths[tail.first].EvaluateFrom(*obj, tail.second);
+        if(res) results[tail.first] = res;
+    }
+    for(int child : n.children){
+        const GonObject* next = GonPath::Step(*obj, paths[nodes[child].path].Segments()[nodes[child].segment]);
+        if(next) EvaluateNode(child, next, results);
+    }
+}
+
+void GonPathBatch::Evaluate(const GonObject& root, std::vector<const GonObject*>& results) const {
+    results.assign(paths.size(), &GonObject::null_gon);
+    EvaluateNode(0, &root, results);
+}
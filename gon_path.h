@@ -0,0 +1,79 @@
+//Glaiel Object Notation
+//precompiled field paths
+
+#pragma once
+#include "gon.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+//a path is parsed once and can then be evaluated against any GonObject
+//syntax:
+//    units.archer.weapons[2].damage    named fields, [n] is operator[](int)
+//    dup@1                             NthChildWithName("dup", 1)
+//    ?variant.damage                   if variant.damage exists use it, otherwise damage (the ChildOrSelf/FieldInChildOrSelf pattern)
+//                                      a trailing ?variant is ChildOrSelf("variant")
+//    "quoted key".x                    names with spaces, dots or brackets
+//the empty path evaluates to the root itself
+//missing fields evaluate to null_gon, and last_accessed_named_field is only set (to the whole path) on a miss
+//a malformed path is reported once when it's parsed and then misses on every tree
+class GonPath {
+    public:
+        struct Segment {
+            std::pmr::string name; //key built once, so lookups don't construct temporaries
+            int index;             //array index if name is empty, otherwise which duplicate of name to pick
+            bool is_index;
+            bool optional;
+        };
+
+        GonPath();
+        GonPath(std::string_view path); //malformed paths are reported through GonObject::ErrorCallback
+
+        const GonObject& Evaluate(const GonObject& root) const;
+        GonObject& Evaluate(GonObject& root) const;
+        const GonObject& operator()(const GonObject& root) const;
+        GonObject& operator()(GonObject& root) const;
+
+        const std::string& ToString() const;
+        const std::vector<Segment>& Segments() const;
+        bool Valid() const; //false if the path was malformed
+
+        //resolves one segment, nullptr if the child does not exist
+        static const GonObject* Step(const GonObject& obj, const Segment& segment);
+        //evaluates segments [first, segments.size()) starting at obj, nullptr on a miss
+        const GonObject* EvaluateFrom(const GonObject& obj, size_t first) const;
+
+    private:
+        std::vector<Segment> segments;
+        std::string text;
+        bool valid;
+};
+
+//evaluates many paths against one tree, resolving each shared prefix only once
+//(paths are merged into a trie up to their first ?optional segment, the rest of such paths is evaluated per path)
+class GonPathBatch {
+    public:
+        GonPathBatch();
+
+        //returns the index of the path in the results of Evaluate
+        int Add(const GonPath& path);
+        int Add(std::string_view path);
+        int Size() const;
+
+        //results[i] is the value of the i-th added path, null_gon if it does not exist
+        void Evaluate(const GonObject& root, std::vector<const GonObject*>& results) const;
+
+    private:
+        struct Node {
+            int path;       //the segment this node resolves is paths[path].Segments()[segment], path is -1 for the root
+            size_t segment;
+            std::vector<int> children;
+            std::vector<int> finished_paths;         //paths that end at this node
+            std::vector<std::pair<int, size_t>> tails; //paths that continue from this node with an optional segment: (path, first remaining segment)
+        };
+
+        void EvaluateNode(int node, const GonObject* obj, std::vector<const GonObject*>& results) const;
+
+        std::vector<GonPath> paths;
+        std::vector<Node> nodes;
+};
@@ -0,0 +1,164 @@
+#include "gon_snapshot.h"
+
+//epoch based reclamation shared by all snapshots:
+//a reader announces the global epoch in its thread's slot before loading a tree pointer and clears the slot when done,
+//a writer swaps the pointer, bumps the epoch, and frees the old tree once every active slot shows an epoch at or after the bump
+//(any reader that announced that epoch loaded the pointer after the swap, so it can't be holding the old tree)
+//threads that find every slot taken count themselves in overflow_readers instead, and nothing is freed while that count isn't 0
+
+struct alignas(64) GonReaderSlot {
+    std::atomic<uint64_t> epoch;  //0 when the thread isn't reading
+    std::atomic<bool> in_use;     //claimed by a thread
+};
+
+static GonReaderSlot reader_slots[GonSnapshot::MaxReaderThreads];
+static std::atomic<uint64_t> global_epoch(1);
+static std::atomic<int> overflow_readers(0); //readers on threads without a slot
+
+//claims a slot the first time a thread reads and gives it back when the thread exits
+struct GonReaderThread {
+    GonReaderSlot* slot; //nullptr if every slot was taken, the thread then reads through overflow_readers
+    int depth; //guards held by this thread, only the outermost one announces/clears the epoch
+
+    GonReaderThread():slot(nullptr),depth(0){
+        for(int i = 0; i<GonSnapshot::MaxReaderThreads; i++){
+            bool expected = false;
+            if(!reader_slots[i].in_use.load(std::memory_order_relaxed) && reader_slots[i].in_use.compare_exchange_strong(expected, true)){
+                slot = &reader_slots[i];
+                return;
+            }
+        }
+        GonObject::ErrorCallback("GON ERROR: more than GonSnapshot::MaxReaderThreads threads are reading snapshots");
+    }
+    ~GonReaderThread(){
+        if(slot){
+            slot->epoch.store(0);
+            slot->in_use.store(false);
+        }
+    }
+};
+
+static GonReaderThread& ThisReaderThread(){
+    static thread_local GonReaderThread reader;
+    return reader;
+}
+
+static void BeginRead(){
+    GonReaderThread& reader = ThisReaderThread();
+    if(reader.depth++ == 0){
+        if(reader.slot) reader.slot->epoch.store(global_epoch.load()); //seq_cst, so the announcement is visible before the tree pointer is loaded
+        else overflow_readers.fetch_add(1);
+    }
+}
+
+static void EndRead(){
+    GonReaderThread& reader = ThisReaderThread();
+    if(--reader.depth == 0){
+        if(reader.slot) reader.slot->epoch.store(0, std::memory_order_release);
+        else overflow_readers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+//oldest epoch any reader is currently in, UINT64_MAX if nobody is reading
+//0 while an overflow reader is reading, since it could hold any tree retired so far
+static uint64_t OldestReaderEpoch(){
+    if(overflow_readers.load() != 0) return 0;
+    uint64_t oldest = UINT64_MAX;
+    for(int i = 0; i<GonSnapshot::MaxReaderThreads; i++){
+        uint64_t epoch = reader_slots[i].epoch.load();
+        if(epoch != 0 && epoch < oldest) oldest = epoch;
+    }
+    return oldest;
+}
+
+
+GonSnapshot::ReadGuard::ReadGuard():tree(nullptr){
+}
+GonSnapshot::ReadGuard::ReadGuard(const GonObject* tree):tree(tree){
+}
+GonSnapshot::ReadGuard::ReadGuard(ReadGuard&& other):tree(other.tree){
+    other.tree = nullptr;
+}
+GonSnapshot::ReadGuard& GonSnapshot::ReadGuard::operator=(ReadGuard&& other){
+    if(this != &other){
+        Release();
+        tree = other.tree;
+        other.tree = nullptr;
+    }
+    return *this;
+}
+GonSnapshot::ReadGuard::~ReadGuard(){
+    Release();
+}
+
+const GonObject& GonSnapshot::ReadGuard::operator*() const {
+    return Get();
+}
+const GonObject* GonSnapshot::ReadGuard::operator->() const {
+    return &Get();
+}
+const GonObject& GonSnapshot::ReadGuard::Get() const {
+    if(!tree) return GonObject::null_gon;
+    return *tree;
+}
+
+void GonSnapshot::ReadGuard::Release(){
+    if(tree){
+        tree = nullptr;
+        EndRead();
+    }
+}
+
+
+GonSnapshot::GonSnapshot():current(new GonObject()){
+}
+GonSnapshot::GonSnapshot(GonObject initial):current(new GonObject(std::move(initial))){
+}
+GonSnapshot::~GonSnapshot(){
+    delete current.load();
+    for(auto& entry : retired){
+        delete entry.first;
+    }
+}
+
+GonSnapshot::ReadGuard GonSnapshot::Read() const {
+    BeginRead();
+    return ReadGuard(current.load());
+}
+
+void GonSnapshot::Publish(GonObject replacement){
+    GonObject* tree = new GonObject(std::move(replacement));
+
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    GonObject* old = current.exchange(tree);
+    uint64_t epoch = global_epoch.fetch_add(1) + 1;
+    retired.push_back(std::make_pair(old, epoch));
+
+    ReclaimLocked();
+}
+
+int GonSnapshot::Reclaim(){
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    return ReclaimLocked();
+}
+
+int GonSnapshot::ReclaimLocked(){
+    uint64_t oldest = OldestReaderEpoch();
+
+    std::vector<GonObject*> freed;
+    for(size_t i = 0; i<retired.size();){
+        if(retired[i].second <= oldest){
+            freed.push_back(retired[i].first);
+            retired[i] = retired.back();
+            retired.pop_back();
+        } else {
+            i++;
+        }
+    }
+    int remaining = (int)retired.size();
+
+    for(GonObject* tree : freed){
+        delete tree;
+    }
+    return remaining;
+}
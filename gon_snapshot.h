@@ -0,0 +1,78 @@
+//Glaiel Object Notation
+//lock-free publishing of immutable trees for live reloads
+
+#pragma once
+#include "gon.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+//holds the current version of a tree that many threads read while another thread occasionally replaces it
+//readers pin the current tree with Read(), which is wait-free (one epoch announcement plus one atomic load), and keep it alive for as long as the guard exists
+//writers build a complete replacement (Load, PatchMerge, ...) and Publish it, the old tree is destroyed once no reader that could have seen it is still reading
+//
+//    GonSnapshot config(GonObject::Load("server.gon"));
+//
+//    //request threads
+//    GonSnapshot::ReadGuard cfg = config.Read();
+//    int port = (*cfg)["port"].Int();
+//
+//    //admin thread
+//    GonObject next = GonObject::Load("server.gon");
+//    next.PatchMerge(overrides);
+//    config.Publish(std::move(next));
+//
+//a published tree must not be modified, readers only ever get const access to it
+//up to MaxReaderThreads threads get their own epoch slot, a thread past that is reported through ErrorCallback on its first Read
+//if the callback returns, those threads share one reader count instead, which is still safe but keeps retired trees alive until none of them is reading
+class GonSnapshot {
+    public:
+        static const int MaxReaderThreads = 256;
+
+        class ReadGuard {
+            public:
+                ReadGuard();
+                ReadGuard(ReadGuard&& other);
+                ReadGuard& operator=(ReadGuard&& other);
+                ReadGuard(const ReadGuard&) = delete;
+                ReadGuard& operator=(const ReadGuard&) = delete;
+                ~ReadGuard();
+
+                const GonObject& operator*() const;
+                const GonObject* operator->() const;
+                const GonObject& Get() const;
+
+                void Release();
+
+            private:
+                friend class GonSnapshot;
+                explicit ReadGuard(const GonObject* tree);
+
+                const GonObject* tree;
+        };
+
+        GonSnapshot();
+        explicit GonSnapshot(GonObject initial);
+        ~GonSnapshot(); //no reader may hold a guard when the snapshot is destroyed
+
+        GonSnapshot(const GonSnapshot&) = delete;
+        GonSnapshot& operator=(const GonSnapshot&) = delete;
+
+        ReadGuard Read() const;
+
+        //atomically replaces the current tree, then frees whatever retired trees are no longer visible to any reader
+        void Publish(GonObject replacement);
+
+        //frees retired trees that no reader can still see, returns how many are still waiting on readers
+        int Reclaim();
+
+    private:
+        int ReclaimLocked();
+
+        std::atomic<GonObject*> current;
+
+        std::mutex writer_mutex;
+        std::vector<std::pair<GonObject*, uint64_t>> retired; //tree, epoch it was retired in
+};
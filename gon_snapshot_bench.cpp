@@ -0,0 +1,191 @@
+//Glaiel Object Notation
+//gon_snapshot_bench: reader latency of GonSnapshot as the number of reader threads grows, with a writer publishing in the background
+//
+//build:
+//    g++ -O2 -std=c++17 -pthread gon_snapshot_bench.cpp gon_snapshot.cpp gon.cpp -o gon_snapshot_bench
+//usage:
+//    gon_snapshot_bench [--threads 1,2,4,8,16] [--seconds 1] [--publish-ms 5] [--json]
+//
+//per thread count it runs every reader for --seconds, each read being Read() plus one field lookup on the pinned tree, while one
+//writer publishes a fresh copy of the tree every --publish-ms milliseconds, and reports:
+//    snapshot    GonSnapshot::Read
+//    mutex       the same reads through a std::shared_ptr swapped under a std::mutex, for comparison
+//latencies are of single reads (every 16th read is timed, up to 65536 per thread), p50/p99/max over all readers, reads/s is all readers together
+//with enough cores the snapshot rows stay flat as threads are added, readers never wait on each other or on the writer
+//(with fewer cores than threads the numbers mostly show scheduling)
+//more than GonSnapshot::MaxReaderThreads threads also covers the shared overflow count, the error for that is printed once
+
+#include "gon_snapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static double Now(){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//a server-config sized tree, 200 settings plus a few nested tables
+static std::string GenerateConfig(){
+    std::string out;
+    for(int i = 0; i<200; i++){
+        out += "setting_" + std::to_string(i) + " " + std::to_string(i * 37 % 1000) + "\n";
+    }
+    for(int i = 0; i<20; i++){
+        out += "table_" + std::to_string(i) + " { port " + std::to_string(8000 + i) + " hosts [a b c d] limits { rate 100 burst 20 } }\n";
+    }
+    return out;
+}
+
+//the shared_ptr under a mutex that a GonSnapshot would replace
+struct GonBenchLockedTree {
+    std::mutex mutex;
+    std::shared_ptr<const GonObject> tree;
+
+    std::shared_ptr<const GonObject> Read(){
+        std::lock_guard<std::mutex> lock(mutex);
+        return tree;
+    }
+    void Publish(GonObject replacement){
+        std::shared_ptr<const GonObject> next = std::make_shared<const GonObject>(std::move(replacement));
+        std::lock_guard<std::mutex> lock(mutex);
+        tree.swap(next);
+    }
+};
+
+struct GonBenchLatency {
+    std::vector<double> samples; //seconds
+    size_t reads = 0;
+};
+
+static double Percentile(const std::vector<double>& sorted, double fraction){
+    if(sorted.empty()) return 0;
+    return sorted[std::min(sorted.size()-1, (size_t)(fraction * (double)sorted.size()))];
+}
+
+//runs threads readers and one writer for seconds, read(i) does one read and returns the value it found (summed so it isn't optimized away)
+template<class Read, class Publish>
+static void Run(const char* name, int threads, double seconds, int publish_ms, bool json, Read read, Publish publish){
+    std::atomic<bool> start(false), stop(false);
+    std::vector<GonBenchLatency> latencies(threads);
+    std::vector<std::thread> readers;
+    std::atomic<int64_t> checksum(0);
+
+    for(int t = 0; t<threads; t++){
+        readers.emplace_back([&, t]{
+            GonBenchLatency& latency = latencies[t];
+            latency.samples.reserve(1 << 16);
+            int64_t sum = 0;
+            while(!start.load()) std::this_thread::yield();
+            for(size_t i = 0; !stop.load(std::memory_order_relaxed); i++){
+                if(i % 16 == 0 && latency.samples.size() < latency.samples.capacity()){
+                    double begin = Now();
+                    sum += read(i);
+                    latency.samples.push_back(Now() - begin);
+                } else {
+                    sum += read(i);
+                }
+                latency.reads++;
+            }
+            checksum += sum;
+        });
+    }
+
+    int publishes = 0;
+    double begin = Now();
+    start = true;
+    while(Now() - begin < seconds){
+        std::this_thread::sleep_for(std::chrono::milliseconds(publish_ms));
+        publish();
+        publishes++;
+    }
+    stop = true;
+    double elapsed = Now() - begin;
+    for(std::thread& reader : readers) reader.join();
+
+    std::vector<double> samples;
+    size_t reads = 0;
+    for(GonBenchLatency& latency : latencies){
+        samples.insert(samples.end(), latency.samples.begin(), latency.samples.end());
+        reads += latency.reads;
+    }
+    std::sort(samples.begin(), samples.end());
+
+    char line[512];
+    if(json){
+        snprintf(line, sizeof(line), "{\"bench\":\"%s\",\"threads\":%d,\"p50_ns\":%.1f,\"p99_ns\":%.1f,\"max_us\":%.1f,\"reads_per_s\":%.0f,\"publishes\":%d}",
+            name, threads, Percentile(samples, 0.5)*1e9, Percentile(samples, 0.99)*1e9, (samples.empty() ? 0 : samples.back())*1e6, (double)reads / elapsed, publishes);
+    } else {
+        snprintf(line, sizeof(line), "%-9s %4d threads %9.1f ns p50 %9.1f ns p99 %10.1f us max %14.0f reads/s %6d publishes",
+            name, threads, Percentile(samples, 0.5)*1e9, Percentile(samples, 0.99)*1e9, (samples.empty() ? 0 : samples.back())*1e6, (double)reads / elapsed, publishes);
+    }
+    std::cout << line << std::endl;
+    if(checksum.load() == 0) std::cerr << "gon_snapshot_bench: reads found nothing\n";
+}
+
+static std::vector<std::string> SplitList(const std::string& str){
+    std::vector<std::string> res;
+    std::stringstream stream(str);
+    std::string item;
+    while(std::getline(stream, item, ',')) if(!item.empty()) res.push_back(item);
+    return res;
+}
+
+int main(int argc, char** argv){
+    std::vector<int> thread_counts = {1, 2, 4, 8, 16};
+    double seconds = 1;
+    int publish_ms = 5;
+    bool json = false;
+    for(int i = 1; i<argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--threads" && i+1 < argc){
+            thread_counts.clear();
+            for(const std::string& count : SplitList(argv[++i])) thread_counts.push_back(std::max(1, atoi(count.c_str())));
+        }
+        else if(arg == "--seconds" && i+1 < argc) seconds = atof(argv[++i]);
+        else if(arg == "--publish-ms" && i+1 < argc) publish_ms = std::max(1, atoi(argv[++i]));
+        else if(arg == "--json") json = true;
+        else {
+            std::cerr << "usage: gon_snapshot_bench [--threads 1,2,4,8,16] [--seconds 1] [--publish-ms 5] [--json]\n";
+            return 1;
+        }
+    }
+
+    //past MaxReaderThreads readers, report it once and let the extra threads read through the shared overflow count
+    static std::atomic<bool> reported(false);
+    GonObject::ErrorCallback = [](const std::string& error){
+        if(!reported.exchange(true)) std::cerr << "gon_snapshot_bench: " << error << "\n";
+    };
+
+    const GonObject config = GonObject::LoadFromBuffer(GenerateConfig());
+    static const char* keys[] = {"setting_7", "setting_150", "setting_3", "setting_42"};
+
+    for(int threads : thread_counts){
+        GonSnapshot snapshot{GonObject(config)};
+        Run("snapshot", threads, seconds, publish_ms, json,
+            [&](size_t i){
+                GonSnapshot::ReadGuard tree = snapshot.Read();
+                return (*tree)[keys[i & 3]].Int64() + 1;
+            },
+            [&]{ snapshot.Publish(GonObject(config)); });
+
+        GonBenchLockedTree locked;
+        locked.Publish(GonObject(config));
+        Run("mutex", threads, seconds, publish_ms, json,
+            [&](size_t i){
+                std::shared_ptr<const GonObject> tree = locked.Read();
+                return (*tree)[keys[i & 3]].Int64() + 1;
+            },
+            [&]{ locked.Publish(GonObject(config)); });
+    }
+    return 0;
+}
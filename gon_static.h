@@ -0,0 +1,256 @@
+//Glaiel Object Notation
+//read-only view over static node tables
+
+#pragma once
+#include "gon.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+//the tables are plain constant data, so nothing runs at startup
+//with C++20 the views can also be used in constant expressions (including lookups that miss)
+#if defined(__cpp_lib_is_constant_evaluated)
+#define GON_STATIC_AT_RUNTIME() (!std::is_constant_evaluated())
+#else
+#define GON_STATIC_AT_RUNTIME() true
+#endif
+
+//node layout shared by GonStatic (gon_constexpr.h) and the tables generated by gon2cpp
+struct GonStaticNode {
+    GonObject::FieldType type;
+    bool bool_data;
+    uint32_t name;          //offset and length in the string pool
+    uint32_t name_length;
+    uint32_t string_data;
+    uint32_t string_length;
+    uint32_t first_child;   //children are nodes[first_child, first_child+child_count)
+    uint32_t child_count;
+    uint32_t keys;          //objects: index[keys, keys+key_count) are child node indexes sorted by name, one per name (the last duplicate, like operator[])
+    uint32_t key_count;
+    int64_t int_data;
+    double float_data;
+};
+
+//a const view of one node, mirroring the read side of GonObject's API (returned by value, it's three pointers and an index)
+class GonStaticView {
+    public:
+        static constexpr uint32_t NullIndex = 0xFFFFFFFF;
+
+        class Iterator {
+            public:
+                constexpr Iterator(const GonStaticNode* nodes, const char* pool, const uint32_t* keys, uint32_t index):nodes(nodes),pool(pool),keys(keys),index(index){
+                }
+                constexpr GonStaticView operator*() const {
+                    return GonStaticView(nodes, pool, keys, index);
+                }
+                constexpr Iterator& operator++(){
+                    index++;
+                    return *this;
+                }
+                constexpr bool operator!=(const Iterator& other) const {
+                    return index != other.index;
+                }
+                constexpr bool operator==(const Iterator& other) const {
+                    return index == other.index;
+                }
+
+            private:
+                const GonStaticNode* nodes;
+                const char* pool;
+                const uint32_t* keys;
+                uint32_t index;
+        };
+
+        constexpr GonStaticView():nodes(nullptr),pool(nullptr),keys(nullptr),index(NullIndex){
+        }
+        constexpr GonStaticView(const GonStaticNode* nodes, const char* pool, const uint32_t* keys, uint32_t index):nodes(nodes),pool(pool),keys(keys),index(index){
+        }
+
+        constexpr GonObject::FieldType Type() const {
+            return index == NullIndex ? GonObject::FieldType::NULLGON : nodes[index].type;
+        }
+        constexpr std::string_view Name() const {
+            if(index == NullIndex) return std::string_view();
+            return std::string_view(pool + nodes[index].name, nodes[index].name_length);
+        }
+        constexpr std::string_view StringView() const {
+            if(index == NullIndex) return std::string_view();
+            return std::string_view(pool + nodes[index].string_data, nodes[index].string_length);
+        }
+
+        //throw error if accessing wrong type, otherwise return correct type
+        std::string String() const {
+            if(!IsStringLike()) FieldError(Exists() ? "is not a string" : "does not exist");
+            return std::string(StringView());
+        }
+        constexpr const char* CString() const {
+            if(!IsStringLike()) FieldError(Exists() ? "is not a string" : "does not exist");
+            if(index == NullIndex) return "";
+            return pool + nodes[index].string_data;
+        }
+        constexpr int Int() const {
+            return (int)Int64();
+        }
+        constexpr int64_t Int64() const {
+            if(Type() != GonObject::FieldType::NUMBER) FieldError(Exists() ? "is not a number" : "does not exist");
+            return Data().int_data;
+        }
+        constexpr double Number() const {
+            if(Type() != GonObject::FieldType::NUMBER) FieldError(Exists() ? "is not a number" : "does not exist");
+            return Data().float_data;
+        }
+        constexpr bool Bool() const {
+            if(Type() != GonObject::FieldType::BOOL) FieldError(Exists() ? "is not a bool" : "does not exist");
+            return Data().bool_data;
+        }
+
+        //returns a default value if the field doesn't exist or is the wrong type
+        std::string String(const std::string& _default) const {
+            if(!IsStringLike()) return _default;
+            return std::string(StringView());
+        }
+        constexpr const char* CString(const char* _default) const {
+            if(!IsStringLike()) return _default;
+            return pool + nodes[index].string_data;
+        }
+        constexpr int Int(int _default) const {
+            if(Type() != GonObject::FieldType::NUMBER) return _default;
+            return (int)nodes[index].int_data;
+        }
+        constexpr int64_t Int64(int64_t _default) const {
+            if(Type() != GonObject::FieldType::NUMBER) return _default;
+            return nodes[index].int_data;
+        }
+        constexpr double Number(double _default) const {
+            if(Type() != GonObject::FieldType::NUMBER) return _default;
+            return nodes[index].float_data;
+        }
+        constexpr bool Bool(bool _default) const {
+            if(Type() != GonObject::FieldType::BOOL) return _default;
+            return nodes[index].bool_data;
+        }
+
+        constexpr bool Contains(std::string_view child) const {
+            return FindChild(child) != NullIndex;
+        }
+        constexpr bool Contains(int child) const {
+            if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return true;
+            return child >= 0 && child < (int)nodes[index].child_count;
+        }
+        constexpr bool Exists() const {
+            return Type() != GonObject::FieldType::NULLGON;
+        }
+
+        //returns a null view if the field does not exist
+        constexpr GonStaticView operator[](std::string_view child) const {
+            uint32_t found = FindChild(child);
+            if(found == NullIndex && GON_STATIC_AT_RUNTIME()) GonObject::last_accessed_named_field = child;
+            return GonStaticView(nodes, pool, keys, found);
+        }
+        constexpr GonStaticView ChildOrSelf(std::string_view child) const {
+            if(Contains(child)) return (*this)[child];
+            return *this;
+        }
+        constexpr GonStaticView NthChildWithName(std::string_view child, int nth) const {
+            if(nth == 0) return (*this)[child];
+            if(Type() == GonObject::FieldType::OBJECT){
+                for(GonStaticView entry : *this){
+                    if(entry.Name() == child){
+                        if(nth-- == 0) return entry;
+                    }
+                }
+            }
+            if(GON_STATIC_AT_RUNTIME()) GonObject::last_accessed_named_field = child;
+            return GonStaticView(nodes, pool, keys, NullIndex);
+        }
+        constexpr GonStaticView FieldInChildOrSelf(std::string_view child, std::string_view field) const {
+            GonStaticView res = (*this)[child][field];
+            if(res.Exists()) return res;
+            return (*this)[field];
+        }
+        constexpr GonStaticView operator[](int childindex) const {
+            if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return *this;
+            if(childindex < 0 || childindex >= (int)nodes[index].child_count) return GonStaticView(nodes, pool, keys, NullIndex);
+            return GonStaticView(nodes, pool, keys, nodes[index].first_child + childindex);
+        }
+
+        constexpr int Size() const {
+            return size();
+        }
+        constexpr int size() const {
+            if(Type() == GonObject::FieldType::NULLGON) return 0;
+            if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return 1;//size 1, object is self
+            return (int)nodes[index].child_count;
+        }
+        constexpr bool empty() const {
+            return index == NullIndex || nodes[index].child_count == 0;
+        }
+        constexpr Iterator begin() const {
+            if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return Iterator(nodes, pool, keys, index);
+            return Iterator(nodes, pool, keys, nodes[index].first_child);
+        }
+        constexpr Iterator end() const {
+            if(Type() == GonObject::FieldType::NULLGON) return Iterator(nodes, pool, keys, index);
+            if(Type() != GonObject::FieldType::OBJECT && Type() != GonObject::FieldType::ARRAY) return Iterator(nodes, pool, keys, index+1);
+            return Iterator(nodes, pool, keys, nodes[index].first_child + nodes[index].child_count);
+        }
+
+        //copies the subtree into a regular, mutable GonObject
+        GonObject ToGonObject() const {
+            GonObject res;
+            if(index == NullIndex) return res;
+            const GonStaticNode& node = nodes[index];
+            res.type = node.type;
+            res.name = Name();
+            res.string_data = StringView();
+            res.int_data = node.int_data;
+            res.float_data = node.float_data;
+            res.bool_data = node.bool_data;
+            if(node.type != GonObject::FieldType::OBJECT && node.type != GonObject::FieldType::ARRAY) return res;
+            for(GonStaticView child : *this){
+                if(node.type == GonObject::FieldType::OBJECT) res.InsertChild(child.Name(), child.ToGonObject());
+                else res.children_array.push_back(child.ToGonObject());
+            }
+            return res;
+        }
+
+    private:
+        //what a missing field reads as when ErrorCallback doesn't throw (the same values as null_gon)
+        static constexpr GonStaticNode null_node = {GonObject::FieldType::NULLGON, false, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+        constexpr const GonStaticNode& Data() const {
+            return index == NullIndex ? null_node : nodes[index];
+        }
+
+        constexpr bool IsStringLike() const {
+            GonObject::FieldType type = Type();
+            return type == GonObject::FieldType::STRING || type == GonObject::FieldType::NUMBER || type == GonObject::FieldType::BOOL;
+        }
+
+        void FieldError(const char* what) const {
+            std::string_view name = Name();
+            GonObject::ErrorCallback("GON ERROR: Field \""+(!name.empty()?std::string(name):GonObject::last_accessed_named_field)+"\" "+what);
+        }
+
+        //binary search over the object's sorted key index
+        constexpr uint32_t FindChild(std::string_view child) const {
+            if(Type() != GonObject::FieldType::OBJECT) return NullIndex;
+            const GonStaticNode& node = nodes[index];
+            uint32_t lo = 0, hi = node.key_count;
+            while(lo < hi){
+                uint32_t mid = (lo + hi) / 2;
+                const GonStaticNode& entry = nodes[keys[node.keys+mid]];
+                std::string_view name(pool + entry.name, entry.name_length);
+                if(name == child) return keys[node.keys+mid];
+                if(name < child) lo = mid+1;
+                else hi = mid;
+            }
+            return NullIndex;
+        }
+
+        const GonStaticNode* nodes;
+        const char* pool;
+        const uint32_t* keys;
+        uint32_t index;
+};
@@ -0,0 +1,228 @@
+#include "gon_table.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+static uint32_t TypeBit(GonObject::FieldType type){
+    return 1u << (int)type;
+}
+
+static GonObject::FieldType ColumnType(uint32_t types){
+    const uint32_t scalars = TypeBit(GonObject::FieldType::STRING) | TypeBit(GonObject::FieldType::NUMBER) | TypeBit(GonObject::FieldType::BOOL);
+    if(types == TypeBit(GonObject::FieldType::NUMBER)) return GonObject::FieldType::NUMBER;
+    if(types == TypeBit(GonObject::FieldType::BOOL)) return GonObject::FieldType::BOOL;
+    if((types & ~scalars) == 0) return GonObject::FieldType::STRING;
+    if(types == TypeBit(GonObject::FieldType::OBJECT)) return GonObject::FieldType::OBJECT;
+    if(types == TypeBit(GonObject::FieldType::ARRAY)) return GonObject::FieldType::ARRAY;
+    return GonObject::FieldType::NULLGON;
+}
+
+//same-shaped rows list their fields in the same order, so each field is compared with the previous row's field
+//at the same position first and only goes through the hash map when the shape changes
+struct GonFieldResolver {
+    std::vector<std::pair<std::string_view, int>> last;
+
+    template<class Miss>
+    int Resolve(size_t position, std::string_view name, Miss miss){
+        if(position < last.size() && last[position].first == name) return last[position].second;
+        int column = miss(name);
+        if(position >= last.size()) last.resize(position+1);
+        last[position] = std::make_pair(name, column);
+        return column;
+    }
+};
+
+//runs job(0) ... job(count-1) on the executor and the calling thread, and returns once all of them are done
+//the calling thread claims jobs too, helpers that start after every job was claimed just return, so a busy executor only slows the build down
+static void RunJobs(GonExecutor* executor, size_t count, const std::function<void(size_t)>& job){
+    if(count <= 1){
+        if(count == 1) job(0);
+        return;
+    }
+
+    struct Shared {
+        std::atomic<size_t> next{0};
+        size_t count = 0;
+        size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable finished;
+        const std::function<void(size_t)>* job = nullptr; //only used after claiming a job, while the caller is still waiting
+    };
+    std::shared_ptr<Shared> shared = std::make_shared<Shared>();
+    shared->count = count;
+    shared->job = &job;
+
+    auto Work = [](Shared& state){
+        size_t index;
+        while((index = state.next++) < state.count){
+            (*state.job)(index);
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if(++state.done == state.count) state.finished.notify_all();
+        }
+    };
+
+    size_t helpers = std::min<size_t>(count-1, std::max(1u, std::thread::hardware_concurrency()));
+    for(size_t i = 0; i<helpers; i++){
+        executor->Post([shared, Work]{ Work(*shared); });
+    }
+    Work(*shared);
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->finished.wait(lock, [&]{ return shared->done == shared->count; });
+}
+
+
+bool GonTable::Column::Has(size_t row) const {
+    return (present[row/64] >> (row%64)) & 1;
+}
+
+GonTable::GonTable(){
+}
+
+GonTable::GonTable(const GonObject& collection, const GonTableOptions& options){
+    if(collection.type != GonObject::FieldType::OBJECT && collection.type != GonObject::FieldType::ARRAY) return;
+
+    rows.reserve(collection.children_array.size());
+    for(const GonObject& row : collection.children_array) rows.push_back(&row);
+
+    //jobs cover whole words of the presence bitmaps, so no two jobs write the same word
+    size_t rows_per_job = std::max<size_t>(64, (options.rows_per_job + 63) / 64 * 64);
+    size_t job_count = (rows.size() + rows_per_job - 1) / rows_per_job;
+    GonExecutor* executor = options.executor;
+    if(!executor && job_count > 1) executor = &GonThreadPool::Default();
+
+    //pass 1: each job lists the field names it sees (in first appearance order) and which types they hold
+    struct JobSchema {
+        std::vector<std::pair<std::string_view, uint32_t>> fields;
+    };
+    std::vector<JobSchema> schemas(job_count);
+    RunJobs(executor, job_count, [&](size_t job){
+        JobSchema& schema = schemas[job];
+        std::unordered_map<std::string_view, int> local;
+        GonFieldResolver resolver;
+        size_t end = std::min(rows.size(), (job+1)*rows_per_job);
+        for(size_t row = job*rows_per_job; row<end; row++){
+            if(rows[row]->type != GonObject::FieldType::OBJECT) continue;
+            const std::pmr::vector<GonObject>& fields = rows[row]->children_array;
+            for(size_t i = 0; i<fields.size(); i++){
+                if(fields[i].type == GonObject::FieldType::NULLGON) continue;
+                int column = resolver.Resolve(i, fields[i].name, [&](std::string_view name){
+                    auto iter = local.find(name);
+                    if(iter != local.end()) return iter->second;
+                    local.emplace(name, (int)schema.fields.size());
+                    schema.fields.push_back(std::make_pair(name, 0u));
+                    return (int)schema.fields.size()-1;
+                });
+                schema.fields[column].second |= TypeBit(fields[i].type);
+            }
+        }
+    });
+
+    //merging in job order keeps the columns in first appearance order over the whole collection
+    std::vector<uint32_t> types;
+    for(const JobSchema& schema : schemas){
+        for(auto& field : schema.fields){
+            auto inserted = column_index.emplace(field.first, (int)columns.size());
+            if(inserted.second){
+                columns.emplace_back();
+                columns.back().name = field.first;
+                types.push_back(0);
+            }
+            types[inserted.first->second] |= field.second;
+        }
+    }
+    schemas.clear();
+
+    for(size_t i = 0; i<columns.size(); i++){
+        Column& column = columns[i];
+        column.type = ColumnType(types[i]);
+        column.present.assign((rows.size() + 63) / 64, 0);
+        column.present_count = 0;
+        switch(column.type){
+            case GonObject::FieldType::NUMBER:
+                column.numbers.assign(rows.size(), 0);
+                column.ints.assign(rows.size(), 0);
+                break;
+            case GonObject::FieldType::BOOL:
+                column.bools.assign(rows.size(), 0);
+                break;
+            case GonObject::FieldType::STRING:
+                column.strings.assign(rows.size(), std::string_view());
+                break;
+            default:
+                column.objects.assign(rows.size(), nullptr);
+                break;
+        }
+    }
+
+    //pass 2: each job fills its own rows of every column
+    RunJobs(executor, job_count, [&](size_t job){
+        GonFieldResolver resolver;
+        size_t end = std::min(rows.size(), (job+1)*rows_per_job);
+        for(size_t row = job*rows_per_job; row<end; row++){
+            if(rows[row]->type != GonObject::FieldType::OBJECT) continue;
+            const std::pmr::vector<GonObject>& fields = rows[row]->children_array;
+            for(size_t i = 0; i<fields.size(); i++){
+                const GonObject& field = fields[i];
+                if(field.type == GonObject::FieldType::NULLGON) continue;
+                Column& column = columns[resolver.Resolve(i, field.name, [&](std::string_view name){
+                    return column_index.find(name)->second;
+                })];
+
+                column.present[row/64] |= 1ull << (row%64);
+                switch(column.type){
+                    case GonObject::FieldType::NUMBER:
+                        column.numbers[row] = field.float_data;
+                        column.ints[row] = field.int_data;
+                        break;
+                    case GonObject::FieldType::BOOL:
+                        column.bools[row] = field.bool_data;
+                        break;
+                    case GonObject::FieldType::STRING:
+                        column.strings[row] = field.string_data;
+                        break;
+                    default:
+                        column.objects[row] = &field;
+                        break;
+                }
+            }
+        }
+    });
+
+    for(Column& column : columns){
+        for(uint64_t word : column.present){
+            for(; word; word &= word-1) column.present_count++;
+        }
+    }
+}
+
+size_t GonTable::Rows() const {
+    return rows.size();
+}
+const GonObject& GonTable::Row(size_t row) const {
+    return *rows[row];
+}
+std::string_view GonTable::RowName(size_t row) const {
+    return rows[row]->name;
+}
+
+int GonTable::ColumnCount() const {
+    return (int)columns.size();
+}
+const GonTable::Column& GonTable::GetColumn(int column) const {
+    return columns[column];
+}
+int GonTable::ColumnIndex(std::string_view name) const {
+    auto iter = column_index.find(name);
+    if(iter == column_index.end()) return -1;
+    return iter->second;
+}
+const GonTable::Column* GonTable::Find(std::string_view name) const {
+    int column = ColumnIndex(name);
+    if(column < 0) return nullptr;
+    return &columns[column];
+}
@@ -0,0 +1,64 @@
+//Glaiel Object Notation
+//columnar views of collections of same-shaped entries
+
+#pragma once
+#include "gon.h"
+#include "gon_async.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct GonTableOptions {
+    GonExecutor* executor = nullptr; //GonThreadPool::Default() if null, the calling thread builds too so it never just waits
+    size_t rows_per_job = 16384;     //rounded up to a multiple of 64, collections with fewer rows are built on the calling thread only
+};
+
+//turns an array (or object) of entries into one column per field name found in any entry, struct-of-arrays style:
+//
+//    GonObject units = GonObject::Load("units.gon");
+//    GonTable table(units);
+//    const GonTable::Column* hp = table.Find("hp");
+//    for(size_t row = 0; row<table.Rows(); row++) total += hp->numbers[row];
+//
+//columns are in the order their names first appear, and a row with a duplicate field name gets the value operator[] would return (the last one)
+//entries that aren't objects are rows with no fields
+//names, strings and object pointers refer into the source collection, which must outlive the table and not be modified while it's in use
+class GonTable {
+    public:
+        struct Column {
+            std::string_view name;
+
+            //NUMBER or BOOL if every present value has that type, STRING for any other mix of strings, numbers and bools,
+            //OBJECT or ARRAY if every present value has that type, NULLGON for any other mix that includes objects or arrays
+            GonObject::FieldType type;
+
+            std::vector<double> numbers;           //NUMBER columns, 0 where missing
+            std::vector<int64_t> ints;             //NUMBER columns, 0 where missing
+            std::vector<uint8_t> bools;            //BOOL columns, 0 where missing
+            std::vector<std::string_view> strings; //STRING columns, each value's string_data, empty where missing
+            std::vector<const GonObject*> objects; //OBJECT, ARRAY and NULLGON columns, nullptr where missing
+
+            std::vector<uint64_t> present; //bit row%64 of present[row/64] is set if the row has this field
+            size_t present_count;
+
+            bool Has(size_t row) const;
+        };
+
+        GonTable();
+        explicit GonTable(const GonObject& collection, const GonTableOptions& options = GonTableOptions());
+
+        size_t Rows() const;
+        const GonObject& Row(size_t row) const;
+        std::string_view RowName(size_t row) const; //empty for array entries
+
+        int ColumnCount() const;
+        const Column& GetColumn(int column) const;
+        int ColumnIndex(std::string_view name) const; //-1 if no row has the field
+        const Column* Find(std::string_view name) const; //nullptr if no row has the field
+
+    private:
+        std::vector<const GonObject*> rows;
+        std::vector<Column> columns;
+        std::unordered_map<std::string_view, int> column_index;
+};